@@ -23,7 +23,44 @@
 #include "animation-helper.h"
 
 #include <QWidget>
+#include <QWindow>
+#include <QVariantAnimation>
+#include <QPointer>
+#include <QTimer>
 #include "animator-iface.h"
+#include "animation-quality-governor.h"
+#include "paint-statistics.h"
+
+/*!
+ * \brief The AnimatorSlotData class
+ * \details
+ * The per widget storage of animators. It lives in the QObject's user data,
+ * which Qt deletes when the object is destroyed.
+ */
+class AnimatorSlotData : public QObjectUserData
+{
+public:
+    ~AnimatorSlotData() {
+        for (auto animator : animators) {
+            delete animator;
+        }
+    }
+
+    AnimatorIface *animators[AnimationHelper::SlotCount] = {nullptr};
+};
+
+static uint animatorSlotId()
+{
+    static const uint id = QObject::registerUserData();
+    return id;
+}
+
+static AnimatorSlotData *animatorSlotData(const QWidget *w)
+{
+    if (!w)
+        return nullptr;
+    return static_cast<AnimatorSlotData *>(w->userData(animatorSlotId()));
+}
 
 AnimationHelper::AnimationHelper(QObject *parent) : QObject(parent)
 {
@@ -37,3 +74,71 @@ AnimationHelper::~AnimationHelper()
 //    }
     delete m_animators;
 }
+
+AnimatorIface *AnimationHelper::slotAnimator(const QWidget *w, AnimationHelper::AnimatorSlot slot)
+{
+    auto data = animatorSlotData(w);
+    return data? data->animators[slot]: nullptr;
+}
+
+void AnimationHelper::setSlotAnimator(QWidget *w, AnimationHelper::AnimatorSlot slot, AnimatorIface *animator)
+{
+    auto data = animatorSlotData(w);
+    if (!data) {
+        data = new AnimatorSlotData;
+        w->setUserData(animatorSlotId(), data);
+    }
+    if (data->animators[slot] && data->animators[slot] != animator)
+        delete data->animators[slot];
+    data->animators[slot] = animator;
+}
+
+AnimatorIface *AnimationHelper::takeSlotAnimator(QWidget *w, AnimationHelper::AnimatorSlot slot)
+{
+    auto data = animatorSlotData(w);
+    if (!data)
+        return nullptr;
+    auto animator = data->animators[slot];
+    data->animators[slot] = nullptr;
+    return animator;
+}
+
+bool AnimationHelper::isWidgetExposed(const QWidget *w)
+{
+    if (!w || !w->isVisible())
+        return false;
+
+    auto topLevel = w->window();
+    if (topLevel->isMinimized())
+        return false;
+
+    // widgets embedded in graphics view have no window handle, keep them animated.
+    auto window = topLevel->windowHandle();
+    return !window || window->isExposed();
+}
+
+bool AnimationHelper::shouldAnimate(QWidget *w, QAbstractAnimation *animation)
+{
+    PaintStatistics::count(PaintStatistics::AnimationTicks);
+
+    auto governor = AnimationQualityGovernor::globalInstance();
+    if (governor->level() != AnimationQualityGovernor::Off && isWidgetExposed(w)) {
+        governor->reportFrame();
+        if (auto variantAnimation = qobject_cast<QVariantAnimation *>(animation))
+            governor->adjustDuration(variantAnimation);
+        return true;
+    }
+
+    if (!animation || animation->state() != QAbstractAnimation::Running)
+        return false;
+
+    // do not change the animation's state inside of its own tick.
+    QPointer<QAbstractAnimation> target = animation;
+    QTimer::singleShot(0, animation, [=]() {
+        if (!target || target->state() == QAbstractAnimation::Stopped || target->totalDuration() < 0)
+            return;
+        target->setCurrentTime(target->direction() == QAbstractAnimation::Forward? target->totalDuration(): 0);
+        target->stop();
+    });
+    return false;
+}
@@ -26,15 +26,64 @@
 #include <QObject>
 
 class QWidget;
+class QAbstractAnimation;
 class AnimatorIface;
 
+/*!
+ * \brief The AnimationHelper class
+ * \details
+ * Base class of the style's animation helpers. A helper creates animators
+ * for the widgets it is interested in and hands them out at paint time.
+ *
+ * Animators are attached to their widget through one intrusive slot shared
+ * by all helpers (see QObject::setUserData()). Each helper owns an index
+ * in that slot, so looking up an animator is a plain array access and
+ * the animators are destroyed together with the widget.
+ */
 class AnimationHelper : public QObject
 {
     Q_OBJECT
 public:
+    enum AnimatorSlot {
+        TabWidgetSlot,
+        ScrollBarSlot,
+        ButtonSlot,
+        BoxSlot,
+        SlotCount
+    };
+
     explicit AnimationHelper(QObject *parent = nullptr);
     virtual ~AnimationHelper();
 
+    /*!
+     * \brief slotAnimator
+     * \param w widget which animator bound to.
+     * \param slot index of the helper's animator in widget's slot.
+     * \return animator bound to the widget, nullptr if there is none.
+     */
+    static AnimatorIface *slotAnimator(const QWidget *w, AnimatorSlot slot);
+
+    /*!
+     * \brief isWidgetExposed
+     * \return false if \a w is hidden, or its window is minimized or not exposed.
+     */
+    static bool isWidgetExposed(const QWidget *w);
+
+    /*!
+     * \brief shouldAnimate
+     * \param w widget painted by the animation.
+     * \param animation the animation which is ticking.
+     * \return true if \a w should be updated for current frame.
+     * \details
+     * Animators call this on each tick. When nobody can see the widget, the
+     * animation is snapped to its final state instead of keeping ticking, so
+     * the widget will be painted with the final state once it is exposed again.
+     *
+     * The tick is also reported to AnimationQualityGovernor, which may shorten
+     * the animation, or disable it in the same way as an invisible widget.
+     */
+    static bool shouldAnimate(QWidget *w, QAbstractAnimation *animation);
+
 signals:
 
 public slots:
@@ -42,10 +91,21 @@ public slots:
     virtual bool unregisterWidget(QWidget *) {return false;}
 
 protected:
+    /*!
+     * \brief setSlotAnimator
+     * \details
+     * Attach \a animator to \a w. The slot takes the ownership of the
+     * animator, it will be deleted when the widget is destroyed unless
+     * it is taken back with takeSlotAnimator() before.
+     */
+    static void setSlotAnimator(QWidget *w, AnimatorSlot slot, AnimatorIface *animator);
+    static AnimatorIface *takeSlotAnimator(QWidget *w, AnimatorSlot slot);
+
     /*!
      * \brief m_animators
      * \deprecated
      * You should not use this member in newly-written code.
+     * Use the widget's animator slot instead.
      */
     QHash<const QWidget *, AnimatorIface*> *m_animators = nullptr;
 };
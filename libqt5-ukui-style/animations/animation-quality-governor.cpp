@@ -0,0 +1,219 @@
+/*
+ * Qt5-UKUI's Library
+ *
+ * Copyright (C) 2020, Tianjin KYLIN Information Technology Co., Ltd.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this library.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * Authors: Yue Lan <lanyue@kylinos.cn>
+ *
+ */
+
+#include "animation-quality-governor.h"
+#include "ukui-style-settings.h"
+
+#include <QVariantAnimation>
+#include <QDBusConnection>
+
+/*!
+ * evaluation window of samples, in ms.
+ */
+#define EVALUATION_WINDOW 1000
+
+/*!
+ * ticks closer than this are considered in one frame, and a gap longer
+ * than MAX_FRAME_INTERVAL means animations were idle, not a slow frame.
+ */
+#define MIN_FRAME_INTERVAL 4
+#define MAX_FRAME_INTERVAL 250
+
+#define OBJECT_PATH "/org/ukui/style/AnimationQuality/"
+
+static AnimationQualityGovernor *global_instance = nullptr;
+static int paint_timer_depth = 0;
+
+AnimationQualityGovernor *AnimationQualityGovernor::globalInstance()
+{
+    if (!global_instance) {
+        global_instance = new AnimationQualityGovernor;
+    }
+    return global_instance;
+}
+
+AnimationQualityGovernor::AnimationQualityGovernor(QObject *parent) : QObject(parent)
+{
+    m_clock.start();
+
+    if (UKUIStyleSettings::isSchemaInstalled("org.ukui.style")) {
+        auto settings = UKUIStyleSettings::globalInstance();
+        if (settings->keys().contains("animationQuality"))
+            loadSettings(settings->get("animationQuality").toString());
+        if (settings->keys().contains("lowEndMode"))
+            m_low_end_mode = settings->get("lowEndMode").toBool();
+
+        connect(settings, &QGSettings::changed, this, [=](const QString &key) {
+            if (key == "animationQuality") {
+                loadSettings(settings->get(key).toString());
+            } else if (key == "lowEndMode") {
+                Level oldLevel = level();
+                m_low_end_mode = settings->get(key).toBool();
+                if (level() != oldLevel)
+                    notifyLevelChanged();
+            }
+        });
+    }
+}
+
+void AnimationQualityGovernor::loadSettings(const QString &value)
+{
+    auto values = value.split(",");
+    QString level = values.value(0).trimmed();
+
+    bool ok = false;
+    int frameThreshold = values.value(1).toInt(&ok);
+    m_frame_threshold = ok && frameThreshold > 0? frameThreshold: 34;
+    int paintThreshold = values.value(2).toInt(&ok);
+    m_paint_threshold = ok && paintThreshold > 0? paintThreshold: 4;
+
+    m_automatic = false;
+    if (level == "full") {
+        setLevel(Full);
+    } else if (level == "reduced") {
+        setLevel(Reduced);
+    } else if (level == "off") {
+        setLevel(Off);
+    } else {
+        m_automatic = true;
+    }
+
+    m_overloaded_windows = 0;
+    m_calm_windows = 0;
+}
+
+void AnimationQualityGovernor::setLevel(AnimationQualityGovernor::Level level)
+{
+    if (m_level == level)
+        return;
+
+    m_level = level;
+    if (!m_low_end_mode)
+        notifyLevelChanged();
+}
+
+void AnimationQualityGovernor::notifyLevelChanged()
+{
+    Q_EMIT levelChanged(level());
+    Q_EMIT currentLevelChanged(currentLevel());
+}
+
+QString AnimationQualityGovernor::currentLevel() const
+{
+    switch (level()) {
+    case Full:
+        return "full";
+    case Reduced:
+        return "reduced";
+    default:
+        return "off";
+    }
+}
+
+void AnimationQualityGovernor::exportOnSessionBus(const QString &component)
+{
+    // levelChanged() is not exported, Level is no D-Bus type.
+    QDBusConnection::sessionBus().registerObject(OBJECT_PATH + component, this,
+                                                 QDBusConnection::ExportAllProperties | QDBusConnection::ExportScriptableSignals);
+}
+
+void AnimationQualityGovernor::adjustDuration(QVariantAnimation *animation)
+{
+    QVariant base = animation->property("_ukui_base_duration");
+    int scaled = animation->property("_ukui_scaled_duration").toInt();
+    if (!base.isValid() || animation->duration() != scaled) {
+        // first time, or the animator has changed duration by itself.
+        base = animation->duration();
+        animation->setProperty("_ukui_base_duration", base);
+    }
+
+    scaled = m_level == Full? base.toInt(): base.toInt() / 2;
+    if (animation->duration() != scaled)
+        animation->setDuration(scaled);
+    animation->setProperty("_ukui_scaled_duration", scaled);
+}
+
+void AnimationQualityGovernor::reportFrame()
+{
+    qint64 now = m_clock.elapsed();
+    if (m_last_frame >= 0) {
+        qint64 interval = now - m_last_frame;
+        if (interval < MIN_FRAME_INTERVAL)
+            return;
+        if (interval < MAX_FRAME_INTERVAL) {
+            m_frames++;
+            if (interval > m_frame_threshold)
+                m_slow_frames++;
+        }
+    }
+    m_last_frame = now;
+    evaluate(now);
+}
+
+void AnimationQualityGovernor::reportPaint(qint64 nsecs)
+{
+    m_paints++;
+    if (nsecs > m_paint_threshold * 1000000ll)
+        m_slow_paints++;
+    evaluate(m_clock.elapsed());
+}
+
+void AnimationQualityGovernor::evaluate(qint64 now)
+{
+    if (now - m_window_start < EVALUATION_WINDOW)
+        return;
+
+    if (m_automatic && !m_low_end_mode && m_frames + m_paints > 0) {
+        bool overloaded = (m_frames >= 5 && m_slow_frames * 2 > m_frames)
+                || (m_paints >= 5 && m_slow_paints * 2 > m_paints);
+        bool calm = m_slow_frames * 10 <= m_frames && m_slow_paints * 10 <= m_paints;
+
+        m_overloaded_windows = overloaded? m_overloaded_windows + 1: 0;
+        m_calm_windows = calm? m_calm_windows + 1: 0;
+
+        if (m_overloaded_windows >= 2 && m_level != Off) {
+            setLevel(Level(m_level + 1));
+            m_overloaded_windows = 0;
+        } else if (m_calm_windows >= 3 && m_level != Full) {
+            setLevel(Level(m_level - 1));
+            m_calm_windows = 0;
+        }
+    }
+
+    m_window_start = now;
+    m_frames = 0;
+    m_slow_frames = 0;
+    m_paints = 0;
+    m_slow_paints = 0;
+}
+
+AnimationQualityGovernor::PaintTimer::PaintTimer()
+{
+    if (paint_timer_depth++ == 0)
+        m_timer.start();
+}
+
+AnimationQualityGovernor::PaintTimer::~PaintTimer()
+{
+    if (--paint_timer_depth == 0)
+        AnimationQualityGovernor::globalInstance()->reportPaint(m_timer.nsecsElapsed());
+}
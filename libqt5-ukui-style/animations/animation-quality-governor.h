@@ -0,0 +1,151 @@
+/*
+ * Qt5-UKUI's Library
+ *
+ * Copyright (C) 2020, Tianjin KYLIN Information Technology Co., Ltd.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this library.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * Authors: Yue Lan <lanyue@kylinos.cn>
+ *
+ */
+
+#ifndef ANIMATIONQUALITYGOVERNOR_H
+#define ANIMATIONQUALITYGOVERNOR_H
+
+#include <QObject>
+#include <QElapsedTimer>
+
+class QVariantAnimation;
+
+/*!
+ * \brief The AnimationQualityGovernor class
+ * \details
+ * Measures the style's frame and paint times and lowers the animation
+ * level under sustained overload, then raises it again when there is
+ * headroom.
+ *
+ * Frames are sampled from animators' ticks through AnimationHelper::shouldAnimate(),
+ * paint times are sampled with PaintTimer in QStyle::drawControl(). Samples
+ * are evaluated every second, two overloaded seconds in a row lower the
+ * level by one, three calm seconds in a row raise it by one.
+ *
+ * The behavior is configured by org.ukui.style key "animation-quality",
+ * which is a string of "level,frame threshold,paint threshold". level can be
+ * "auto" for automatic adaptation, or one of "full", "reduced" and "off" to
+ * force a level. Thresholds are in ms, for example "auto,34,4".
+ *
+ * When org.ukui.style "low-end-mode" is on, the level is always Off.
+ *
+ * The level in effect is exported on the session bus connection of the
+ * application, at /org/ukui/style/AnimationQuality/<component> with interface
+ * org.ukui.style.AnimationQuality, as read only property currentLevel and
+ * signal currentLevelChanged, for example:
+ *
+ * qdbus :1.42 /org/ukui/style/AnimationQuality/style org.ukui.style.AnimationQuality.currentLevel
+ */
+class AnimationQualityGovernor : public QObject
+{
+    Q_OBJECT
+    Q_CLASSINFO("D-Bus Interface", "org.ukui.style.AnimationQuality")
+    Q_PROPERTY(QString currentLevel READ currentLevel NOTIFY currentLevelChanged)
+    Q_PROPERTY(bool automatic READ isAutomatic)
+public:
+    enum Level {
+        Full,
+        Reduced,
+        Off
+    };
+    Q_ENUM(Level)
+
+    static AnimationQualityGovernor *globalInstance();
+
+    Level level() const {return m_low_end_mode? Off: m_level;}
+    bool isAutomatic() const {return m_automatic;}
+    int frameThreshold() const {return m_frame_threshold;}
+    int paintThreshold() const {return m_paint_threshold;}
+    /*!
+     * \brief currentLevel
+     * \return level() as its org.ukui.style value, "full", "reduced" or "off".
+     */
+    QString currentLevel() const;
+
+    /*!
+     * \brief exportOnSessionBus
+     * \param component the last element of the object path.
+     */
+    void exportOnSessionBus(const QString &component);
+
+    /*!
+     * \brief adjustDuration
+     * \param animation a running animation.
+     * \details
+     * scale the animation's duration to current level. The original duration
+     * is remembered so it can be restored once the level is raised.
+     */
+    void adjustDuration(QVariantAnimation *animation);
+
+    /*!
+     * \brief reportFrame
+     * called on each animation tick. Ticks of different animations in one
+     * frame are counted once.
+     */
+    void reportFrame();
+    void reportPaint(qint64 nsecs);
+
+    /*!
+     * \brief The PaintTimer class
+     * \details
+     * Measures the outermost painting of its scope, nested ones are ignored.
+     */
+    class PaintTimer
+    {
+    public:
+        PaintTimer();
+        ~PaintTimer();
+
+    private:
+        QElapsedTimer m_timer;
+    };
+
+signals:
+    void levelChanged(Level level);
+    Q_SCRIPTABLE void currentLevelChanged(const QString &level);
+
+protected:
+    explicit AnimationQualityGovernor(QObject *parent = nullptr);
+
+    void loadSettings(const QString &value);
+    void setLevel(Level level);
+    void notifyLevelChanged();
+    void evaluate(qint64 now);
+
+private:
+    Level m_level = Full;
+    bool m_automatic = true;
+    bool m_low_end_mode = false;
+    int m_frame_threshold = 34;
+    int m_paint_threshold = 4;
+
+    QElapsedTimer m_clock;
+    qint64 m_window_start = 0;
+    qint64 m_last_frame = -1;
+    int m_frames = 0;
+    int m_slow_frames = 0;
+    int m_paints = 0;
+    int m_slow_paints = 0;
+    int m_overloaded_windows = 0;
+    int m_calm_windows = 0;
+};
+
+#endif // ANIMATIONQUALITYGOVERNOR_H
@@ -7,7 +7,9 @@ include(scrollbar/scrollbar.pri)
 HEADERS += \
     $$PWD/animator-plugin-iface.h \
     $$PWD/animator-iface.h \
-    $$PWD/animation-helper.h
+    $$PWD/animation-helper.h \
+    $$PWD/animation-quality-governor.h
 
 SOURCES += \
-    $$PWD/animation-helper.cpp
+    $$PWD/animation-helper.cpp \
+    $$PWD/animation-quality-governor.cpp
@@ -21,6 +21,7 @@
  */
 
 #include "ukui-scrollbar-default-interaction-animator.h"
+#include "animation-helper.h"
 #include <QScrollBar>
 
 #include <QVariantAnimation>
@@ -40,18 +41,12 @@ DefaultInteractionAnimator::DefaultInteractionAnimator(QObject *parent) : QParal
  * \return
  *
  * \details
- * QObject has a feature that parent object can use findChild() method
- * getting a specific named child.
+ * The animator is not a child of the scroll bar. ScrollBarAnimationHelper
+ * stores it in the scroll bar's animator slot, which owns it and deletes it
+ * when the scroll bar is destroyed.
  *
- * I use QObject::setObjectName() set my animator and bind to a scroll bar.
- * So that i could not cache a hash or map to manage animators.
- *
- * \bug
- * Cause I use named QObject child to cache the animator for a scrollbar,
- * However there are some troubles for my unexcepted.
- *
- * For example, qt5 assistant's main view can not find child correctly.
- * I don't know if animator bind with child was been removed at some times.
+ * The object name is kept for debugging only, do not use findChild()
+ * to look up the animator.
  */
 bool DefaultInteractionAnimator::bindWidget(QWidget *w)
 {
@@ -85,13 +80,16 @@ bool DefaultInteractionAnimator::bindWidget(QWidget *w)
     setObjectName("ukui_scrollbar_default_interaction_animator");
 
     connect(m_groove_width, &QVariantAnimation::valueChanged, w, [=]() {
-       w->repaint();
+       if (AnimationHelper::shouldAnimate(w, m_groove_width))
+           w->repaint();
     });
     connect(m_slider_opacity, &QVariantAnimation::valueChanged, w, [=]() {
-       w->repaint();
+       if (AnimationHelper::shouldAnimate(w, m_slider_opacity))
+           w->repaint();
     });
     connect(m_sunken_silder_additional_opacity, &QVariantAnimation::valueChanged, w, [=]() {
-       w->repaint();
+       if (AnimationHelper::shouldAnimate(w, m_sunken_silder_additional_opacity))
+           w->repaint();
     });
     connect(m_groove_width, &QVariantAnimation::finished, w, [=]() {
        w->repaint();
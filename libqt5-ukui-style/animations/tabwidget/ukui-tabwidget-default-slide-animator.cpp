@@ -21,6 +21,8 @@
  */
 
 #include "ukui-tabwidget-default-slide-animator.h"
+#include "animation-helper.h"
+#include "animation-quality-governor.h"
 
 #include <QTabWidget>
 #include <QStackedWidget>
@@ -31,12 +33,26 @@
 #include <QPainter>
 
 #include <QTimer>
+#include <QElapsedTimer>
 #include <QGuiApplication>
 #include <QScreen>
 #include <QTabBar>
 
 #include <QDebug>
 
+/*!
+ * \brief SNAPSHOT_FRAME_BUDGET
+ * the longest time in ms the snapshots of a sliding can take, one frame at 60 fps.
+ */
+#define SNAPSHOT_FRAME_BUDGET 16
+
+/*!
+ * \brief SNAPSHOT_COST_DECAY
+ * the estimated cost is scaled by this on every skipped sliding, so that a
+ * single slow measurement does not disable sliding for good.
+ */
+#define SNAPSHOT_COST_DECAY 0.5
+
 using namespace UKUI::TabWidget;
 
 /*!
@@ -110,8 +126,6 @@ bool DefaultSlideAnimator::bindTabWidget(QTabWidget *w)
                         //m_next_pixmap = m_bound_widget->grab(QRect(m_bound_widget->rect().x(), m_bound_widget->tabBar()->height(),
                         //m_bound_widget->currentWidget()->width(), m_bound_widget->currentWidget()->height()));
 
-                        QPixmap pixmap(m_stack->size());
-
                         /*
                          * This way some widget such as QFrame.
                          * QPalette::Window was used to draw the background during the screenshot,
@@ -120,32 +134,7 @@ bool DefaultSlideAnimator::bindTabWidget(QTabWidget *w)
                         */
                         //m_bound_widget->currentWidget()->render(&pixmap, QPoint(), m_bound_widget->currentWidget()->rect());
 
-                        /*
-                         * This way by modifying the way of QPalette, get the same screenshot as the actual state
-                        */
-                        //QPalette palette, palette_save;
-                        //palette = palette_save = m_bound_widget->currentWidget()->palette();
-                        //palette.setBrush(QPalette::Window, palette.brush(QPalette::Base));
-                        //m_bound_widget->currentWidget()->setPalette(palette);
-                        //m_bound_widget->currentWidget()->render(&pixmap, QPoint(), m_bound_widget->currentWidget()->rect());
-                        //m_bound_widget->currentWidget()->setPalette(palette_save);
-
-                        m_bound_widget->render(&pixmap, QPoint(), m_stack->geometry());
-                        m_next_pixmap = pixmap;
-
-                        if (qobject_cast<QWidget *>(previous_widget)) {
-                            QPixmap previous_pixmap(m_stack->size());
-                            QPalette palette = previous_widget->palette();
-                            QPalette palette_save = previous_widget->palette();
-                            /*
-                             * This use QPalette::Base to replace QPalette::Window, Mabey have unknow bug.
-                            */
-                            palette.setBrush(QPalette::Window, palette.brush(QPalette::Base));
-                            previous_widget->setPalette(palette);
-                            previous_widget->render(&previous_pixmap);
-                            previous_widget->setPalette(palette_save);
-                            m_previous_pixmap = previous_pixmap;
-
+                        if (qobject_cast<QWidget *>(previous_widget) && prepareSnapshots()) {
                             switch (w->tabBar()->shape()) {
                             case QTabBar::RoundedNorth:
                             case QTabBar::TriangularNorth:
@@ -172,10 +161,17 @@ bool DefaultSlideAnimator::bindTabWidget(QTabWidget *w)
                 });
 
         connect(this, &QVariantAnimation::valueChanged, m_tmp_page, [=]() {
-            m_tmp_page->repaint();
+            if (AnimationHelper::shouldAnimate(m_bound_widget, this))
+                m_tmp_page->update();
         });
         connect(this, &QVariantAnimation::finished, m_tmp_page, [=]() {
-            m_tmp_page->repaint();
+            // take the outgoing snapshot of next switching now, out of the
+            // first frame of that sliding.
+            if (m_bound_widget && m_bound_widget->currentWidget()) {
+                renderPreviousSnapshot(m_bound_widget->currentWidget());
+                cacheSnapshotOf(m_bound_widget->currentWidget());
+            }
+            m_tmp_page->update();
         });
 
         return true;
@@ -197,7 +193,8 @@ bool DefaultSlideAnimator::unboundTabWidget()
         m_tmp_page = nullptr;
         previous_widget = nullptr;
         m_bound_widget = nullptr;
-        this->deleteLater();
+        // the animator is owned by the tab widget's animator slot,
+        // it will be deleted by TabWidgetAnimationHelper or with the tab widget.
         return true;
     }
     return false;
@@ -214,6 +211,12 @@ bool DefaultSlideAnimator::eventFilter(QObject *obj, QEvent *e)
     if (obj == m_bound_widget) {
         return filterTabWidget(obj, e);
     }
+    if (m_snapshot_page && obj->isWidgetType() && m_snapshot_page->isAncestorOf(static_cast<QWidget *>(obj))) {
+        return filterSnapshotPage(obj, e);
+    }
+    if (obj == m_snapshot_page) {
+        filterSnapshotPage(obj, e);
+    }
     return filterSubPage(obj, e);
 }
 
@@ -244,6 +247,9 @@ bool DefaultSlideAnimator::filterStackedWidget(QObject *obj, QEvent *e)
                 ce->child()->installEventFilter(this);
             } else {
                 ce->child()->removeEventFilter(this);
+                // the page might be deleted next, without more events to us.
+                if (ce->child() == m_snapshot_page)
+                    invalidateSnapshot();
             }
         }
         return false;
@@ -319,52 +325,57 @@ bool DefaultSlideAnimator::filterTmpPage(QObject *obj, QEvent *e)
             p.setRenderHints(QPainter::Antialiasing);
 
             //do a horizon slide.
+            //source rects are in device pixels, target rects are in logical pixels.
+            const qreal prevRatio = m_previous_pixmap.devicePixelRatio();
+            const qreal nextRatio = m_next_pixmap.devicePixelRatio();
+            const QSizeF prevSize = QSizeF(m_previous_pixmap.size()) / prevRatio;
+            const QSizeF nextSize = QSizeF(m_next_pixmap.size()) / nextRatio;
             auto prevSrcRect = QRectF(m_previous_pixmap.rect());
-            auto prevTargetRect = QRectF(m_previous_pixmap.rect());
+            auto prevTargetRect = QRectF(QPointF(), prevSize);
             auto nextSrcRect = QRectF(m_next_pixmap.rect());
-            auto nextTargetRect = QRectF(m_next_pixmap.rect());
+            auto nextTargetRect = QRectF(QPointF(), nextSize);
             if (left_right) {
                 if (horizontal) {
                     prevSrcRect.setY(m_previous_pixmap.height() * value);
                     prevSrcRect.setHeight(m_previous_pixmap.height() * (1 - value));
-                    prevTargetRect.setHeight(m_previous_pixmap.height() * (1 - value));
+                    prevTargetRect.setHeight(prevSize.height() * (1 - value));
                 } else {
                     prevSrcRect.setX(m_previous_pixmap.width() * value);
                     prevSrcRect.setWidth(m_previous_pixmap.width() * (1 - value));
-                    prevTargetRect.setWidth(m_previous_pixmap.width() * (1 - value));
+                    prevTargetRect.setWidth(prevSize.width() * (1 - value));
                 }
                 p.drawPixmap(prevTargetRect, m_previous_pixmap, prevSrcRect);
 
                 if (horizontal) {
                     nextSrcRect.setHeight(m_next_pixmap.height() * value);
-                    nextTargetRect.setY(m_next_pixmap.height() * (1 - value));
-                    nextTargetRect.setHeight(m_next_pixmap.height() * value);
+                    nextTargetRect.setY(nextSize.height() * (1 - value));
+                    nextTargetRect.setHeight(nextSize.height() * value);
                 } else {
                     nextSrcRect.setWidth(m_next_pixmap.width() * value);
-                    nextTargetRect.setX(m_next_pixmap.width() * (1 - value));
-                    nextTargetRect.setWidth(m_next_pixmap.width() * value);
+                    nextTargetRect.setX(nextSize.width() * (1 - value));
+                    nextTargetRect.setWidth(nextSize.width() * value);
                 }
                 p.drawPixmap(nextTargetRect, m_next_pixmap, nextSrcRect);
             } else {
                 if (horizontal) {
                     nextSrcRect.setY(m_next_pixmap.height() * (1 - value));
                     nextSrcRect.setHeight(m_next_pixmap.height() * value);
-                    nextTargetRect.setHeight(m_next_pixmap.height() * value);
+                    nextTargetRect.setHeight(nextSize.height() * value);
                 } else {
                     nextSrcRect.setX(m_next_pixmap.width() * (1 - value));
                     nextSrcRect.setWidth(m_next_pixmap.width() * value);
-                    nextTargetRect.setWidth(m_next_pixmap.width() * value);
+                    nextTargetRect.setWidth(nextSize.width() * value);
                 }
                 p.drawPixmap(nextTargetRect, m_next_pixmap, nextSrcRect);
 
                 if (horizontal) {
                     prevSrcRect.setHeight(m_previous_pixmap.height() * (1 - value));
-                    prevTargetRect.setY(m_previous_pixmap.height() * value);
-                    prevTargetRect.setHeight(m_previous_pixmap.height() * (1 - value));
+                    prevTargetRect.setY(prevSize.height() * value);
+                    prevTargetRect.setHeight(prevSize.height() * (1 - value));
                 } else {
                     prevSrcRect.setWidth(m_previous_pixmap.width() * (1 - value));
-                    prevTargetRect.setX(m_previous_pixmap.width() * value);
-                    prevTargetRect.setWidth(m_previous_pixmap.width() * (1 - value));
+                    prevTargetRect.setX(prevSize.width() * value);
+                    prevTargetRect.setWidth(prevSize.width() * (1 - value));
                 }
                 p.drawPixmap(prevTargetRect, m_previous_pixmap, prevSrcRect);
             }
@@ -387,4 +398,156 @@ void DefaultSlideAnimator::clearPixmap()
 {
     m_previous_pixmap = QPixmap();
     m_next_pixmap = QPixmap();
+    invalidateSnapshot();
+}
+
+/*!
+ * \brief DefaultSlideAnimator::prepareSnapshots
+ * \return \c true if both snapshots are ready for sliding.
+ * \details
+ * The outgoing page's snapshot is reused if the page and its children were
+ * not painted since it was taken at the end of last sliding, otherwise it is
+ * rendered again. The incoming page is always
+ * rendered. Both snapshots are rendered at the stack's device pixel ratio
+ * into the buffers of last sliding, when their size is not changed.
+ *
+ * Rendering a page happens in the same event loop iteration of tab switching,
+ * so it delays the first frame of sliding. If the measured rendering speed
+ * shows that the snapshots would take longer than SNAPSHOT_FRAME_BUDGET ms,
+ * sliding is skipped and the page is switched directly, and the estimate
+ * decays by SNAPSHOT_COST_DECAY until sliding is measured again. Sliding is also
+ * skipped when animations are turned off by AnimationQualityGovernor.
+ */
+bool DefaultSlideAnimator::prepareSnapshots()
+{
+    if (AnimationQualityGovernor::globalInstance()->level() == AnimationQualityGovernor::Off) {
+        invalidateSnapshot();
+        return false;
+    }
+
+    const qreal ratio = m_stack->devicePixelRatioF();
+    const QSize pixelSize = m_stack->size() * ratio;
+    // the tab widget is not laid out yet.
+    if (pixelSize.isEmpty()) {
+        invalidateSnapshot();
+        return false;
+    }
+    const qreal megaPixels = qreal(pixelSize.width()) * pixelSize.height() / 1000000;
+
+    bool reusePrevious = m_snapshot_page && m_snapshot_page == previous_widget
+            && m_previous_pixmap.size() == pixelSize
+            && qFuzzyCompare(m_previous_pixmap.devicePixelRatio(), ratio);
+
+    qreal estimatedCost = m_snapshot_cost * megaPixels * (reusePrevious? 1: 2);
+    invalidateSnapshot();
+    if (estimatedCost > SNAPSHOT_FRAME_BUDGET) {
+        // measured again once the estimate fits, a slow page keeps being skipped.
+        m_snapshot_cost *= SNAPSHOT_COST_DECAY;
+        return false;
+    }
+
+    QElapsedTimer timer;
+    timer.start();
+
+    prepareBuffer(m_next_pixmap, pixelSize, ratio);
+    m_bound_widget->render(&m_next_pixmap, QPoint(), m_stack->geometry());
+
+    if (!reusePrevious)
+        renderPreviousSnapshot(previous_widget);
+
+    // keep a smoothed rendering cost in ms per mega pixels.
+    qreal cost = timer.elapsed() / (megaPixels * (reusePrevious? 1: 2));
+    m_snapshot_cost = m_snapshot_cost > 0? (m_snapshot_cost + cost) / 2: cost;
+
+    return true;
+}
+
+/*!
+ * \brief DefaultSlideAnimator::renderPreviousSnapshot
+ * \param page the outgoing page.
+ * \details
+ * renders \a page into m_previous_pixmap, at the stack's size and device pixel
+ * ratio. A reused snapshot is rendered by this too, so it looks the same as
+ * a fresh one.
+ */
+void DefaultSlideAnimator::renderPreviousSnapshot(QWidget *page)
+{
+    const qreal ratio = m_stack->devicePixelRatioF();
+    prepareBuffer(m_previous_pixmap, m_stack->size() * ratio, ratio);
+    QPalette palette = page->palette();
+    QPalette palette_save = page->palette();
+    /*
+     * This use QPalette::Base to replace QPalette::Window, Mabey have unknow bug.
+    */
+    palette.setBrush(QPalette::Window, palette.brush(QPalette::Base));
+    page->setPalette(palette);
+    page->render(&m_previous_pixmap);
+    page->setPalette(palette_save);
+}
+
+/*!
+ * \brief DefaultSlideAnimator::cacheSnapshotOf
+ * \param page the page which m_previous_pixmap is a snapshot of now.
+ * \details
+ * The page and its children are watched until any of them is painted again.
+ * Paintings happen in the same sync of revealing the page after sliding are
+ * not counted, for they are painting the same content as the snapshot.
+ */
+void DefaultSlideAnimator::cacheSnapshotOf(QWidget *page)
+{
+    invalidateSnapshot();
+    if (!page)
+        return;
+
+    m_snapshot_page = page;
+    m_snapshot_page_destroyed = connect(page, &QObject::destroyed, this, &DefaultSlideAnimator::invalidateSnapshot);
+    m_snapshot_revealing = true;
+    for (auto child : page->findChildren<QWidget *>()) {
+        child->installEventFilter(this);
+        m_snapshot_children << child;
+    }
+}
+
+void DefaultSlideAnimator::invalidateSnapshot()
+{
+    for (auto child : m_snapshot_children) {
+        if (child)
+            child->removeEventFilter(this);
+    }
+    m_snapshot_children.clear();
+    disconnect(m_snapshot_page_destroyed);
+    m_snapshot_page = nullptr;
+    m_snapshot_revealing = false;
+}
+
+bool DefaultSlideAnimator::filterSnapshotPage(QObject *obj, QEvent *e)
+{
+    Q_UNUSED(obj)
+    switch (e->type()) {
+    case QEvent::Paint: {
+        if (m_snapshot_revealing) {
+            // all widgets of the page are painted in one sync when revealed.
+            QTimer::singleShot(0, this, [=]() {
+                m_snapshot_revealing = false;
+            });
+        } else {
+            invalidateSnapshot();
+        }
+        return false;
+    }
+    case QEvent::ChildAdded:
+    case QEvent::ChildRemoved:
+        invalidateSnapshot();
+        return false;
+    default:
+        return false;
+    }
+}
+
+void DefaultSlideAnimator::prepareBuffer(QPixmap &buffer, const QSize &pixelSize, qreal ratio)
+{
+    if (buffer.size() != pixelSize || !qFuzzyCompare(buffer.devicePixelRatio(), ratio)) {
+        buffer = QPixmap(pixelSize);
+        buffer.setDevicePixelRatio(ratio);
+    }
 }
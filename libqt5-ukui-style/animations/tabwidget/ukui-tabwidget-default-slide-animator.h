@@ -29,6 +29,7 @@
 #include "ukui-tabwidget-animator-iface.h"
 
 #include <QPixmap>
+#include <QPointer>
 
 namespace UKUI {
 
@@ -58,8 +59,14 @@ protected:
     bool filterStackedWidget(QObject *obj, QEvent *e);
     bool filterSubPage(QObject *obj, QEvent *e);
     bool filterTmpPage(QObject *obj, QEvent *e);
+    bool filterSnapshotPage(QObject *obj, QEvent *e);
 
     void clearPixmap();
+    bool prepareSnapshots();
+    void renderPreviousSnapshot(QWidget *page);
+    void cacheSnapshotOf(QWidget *page);
+    void invalidateSnapshot();
+    void prepareBuffer(QPixmap &buffer, const QSize &pixelSize, qreal ratio);
 
 private:
     QTabWidget *m_bound_widget = nullptr;
@@ -69,6 +76,24 @@ private:
     QPixmap m_previous_pixmap;
     QPixmap m_next_pixmap;
 
+    /*!
+     * \brief m_snapshot_page
+     * the page which m_previous_pixmap is a snapshot of. The snapshot is
+     * reused for the next sliding unless the page or its children have
+     * been painted again, removed from the stack or deleted, then it is
+     * reset to nullptr.
+     */
+    QPointer<QWidget> m_snapshot_page;
+    QMetaObject::Connection m_snapshot_page_destroyed;
+    QList<QPointer<QWidget>> m_snapshot_children;
+    bool m_snapshot_revealing = false;
+
+    /*!
+     * \brief m_snapshot_cost
+     * measured snapshot rendering cost in ms per mega pixels.
+     */
+    qreal m_snapshot_cost = 0;
+
     /*!
      * \brief m_tmp_page
      * \note
@@ -104,7 +129,7 @@ private:
     int pervIndex = -1;
     bool left_right = true;
     bool horizontal  = false;
-    QWidget *previous_widget = nullptr;
+    QPointer<QWidget> previous_widget;
 };
 
 }
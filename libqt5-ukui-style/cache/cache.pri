@@ -0,0 +1,8 @@
+INCLUDEPATH += $$PWD
+INCLUDEPATH += $$PWD/..
+
+HEADERS += \
+    $$PWD/disk-image-cache.h
+
+SOURCES += \
+    $$PWD/disk-image-cache.cpp
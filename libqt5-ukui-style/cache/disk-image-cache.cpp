@@ -0,0 +1,190 @@
+/*
+ * Qt5-UKUI's Library
+ *
+ * Copyright (C) 2020, Tianjin KYLIN Information Technology Co., Ltd.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this library.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * Authors: Yue Lan <lanyue@kylinos.cn>
+ *
+ */
+
+#include "disk-image-cache.h"
+#include "paint-statistics.h"
+
+#include <QFile>
+#include <QSaveFile>
+#include <QDir>
+#include <QFileInfo>
+#include <QLockFile>
+#include <QStandardPaths>
+#include <QCryptographicHash>
+
+#include <utime.h>
+
+#define DISK_IMAGE_CACHE_MAGIC "UKUIIMG"
+#define DISK_IMAGE_CACHE_VERSION 1
+// total size of the cache, it is evicted to 3/4 of this.
+#define DISK_IMAGE_CACHE_SIZE 32 * 1024 * 1024
+// bytes a process writes before it checks the size of the cache again.
+#define DISK_IMAGE_CACHE_EVICT_INTERVAL 1024 * 1024
+#define DISK_IMAGE_CACHE_MAX_IMAGE_SIZE 1024 * 1024
+
+struct DiskImageHeader
+{
+    char magic[8];
+    quint32 version;
+    quint32 format;
+    qint32 width;
+    qint32 height;
+    qint32 bytesPerLine;
+    quint32 dataSize;
+    double devicePixelRatio;
+};
+
+static DiskImageCache *global_instance = nullptr;
+
+static bool isDisabled()
+{
+    static const bool disabled = qEnvironmentVariableIsSet("QT5UKUI_NO_DISK_CACHE");
+    return disabled;
+}
+
+DiskImageCache *DiskImageCache::globalInstance()
+{
+    if (!global_instance)
+        global_instance = new DiskImageCache;
+    return global_instance;
+}
+
+QString DiskImageCache::cacheDir()
+{
+    return QStandardPaths::writableLocation(QStandardPaths::GenericCacheLocation) + "/ukui-style";
+}
+
+QString DiskImageCache::filePath(const QString &key) const
+{
+    // images painted by another build of the style are never picked up.
+    const QString versionedKey = QString("%1_%2_%3_").arg(DISK_IMAGE_CACHE_VERSION).arg(QT_VERSION_STR).arg(QT5UKUI_BUILD_VERSION) + key;
+    const QByteArray hash = QCryptographicHash::hash(versionedKey.toUtf8(), QCryptographicHash::Sha1).toHex();
+    return cacheDir() + "/" + QString::fromLatin1(hash) + ".img";
+}
+
+bool DiskImageCache::find(const QString &key, QImage *image)
+{
+    if (isDisabled())
+        return false;
+
+    const QString path = filePath(key);
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly) || file.size() < qint64(sizeof(DiskImageHeader))) {
+        PaintStatistics::countCache(PaintStatistics::DiskCacheHits, false);
+        return false;
+    }
+
+    DiskImageHeader header;
+    bool valid = file.read(reinterpret_cast<char *>(&header), sizeof(header)) == sizeof(header)
+            && qstrncmp(header.magic, DISK_IMAGE_CACHE_MAGIC, sizeof(header.magic)) == 0
+            && header.version == DISK_IMAGE_CACHE_VERSION
+            && header.format > QImage::Format_Invalid && header.format < QImage::NImageFormats
+            && header.width > 0 && header.height > 0 && header.bytesPerLine > 0
+            && header.dataSize == quint32(header.bytesPerLine) * quint32(header.height)
+            && header.dataSize == file.size() - sizeof(header);
+
+    // the pixels are copied out, images kept in QPixmapCache must not hold the file open.
+    QImage cached;
+    if (valid) {
+        cached = QImage(header.width, header.height, QImage::Format(header.format));
+        valid = cached.bytesPerLine() == header.bytesPerLine
+                && file.read(reinterpret_cast<char *>(cached.bits()), header.dataSize) == qint64(header.dataSize);
+    }
+    file.close();
+    if (!valid) {
+        QFile::remove(path);
+        PaintStatistics::countCache(PaintStatistics::DiskCacheHits, false);
+        return false;
+    }
+
+    cached.setDevicePixelRatio(header.devicePixelRatio);
+    *image = cached;
+
+    // the modification time is the last use, for eviction.
+    utime(QFile::encodeName(path).constData(), nullptr);
+    PaintStatistics::countCache(PaintStatistics::DiskCacheHits, true);
+    return true;
+}
+
+void DiskImageCache::insert(const QString &key, const QImage &image)
+{
+    if (isDisabled() || image.isNull())
+        return;
+
+    const QImage source = image.format() == QImage::Format_ARGB32_Premultiplied?
+                image: image.convertToFormat(QImage::Format_ARGB32_Premultiplied);
+    const quint32 dataSize = quint32(source.bytesPerLine()) * quint32(source.height());
+    if (dataSize > DISK_IMAGE_CACHE_MAX_IMAGE_SIZE)
+        return;
+
+    DiskImageHeader header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, DISK_IMAGE_CACHE_MAGIC, sizeof(DISK_IMAGE_CACHE_MAGIC));
+    header.version = DISK_IMAGE_CACHE_VERSION;
+    header.format = source.format();
+    header.width = source.width();
+    header.height = source.height();
+    header.bytesPerLine = source.bytesPerLine();
+    header.dataSize = dataSize;
+    header.devicePixelRatio = source.devicePixelRatio();
+
+    QDir().mkpath(cacheDir());
+    QSaveFile file(filePath(key));
+    if (!file.open(QIODevice::WriteOnly))
+        return;
+    file.write(reinterpret_cast<const char *>(&header), sizeof(header));
+    file.write(reinterpret_cast<const char *>(source.constBits()), dataSize);
+    if (!file.commit())
+        return;
+
+    // check the size once per process, then after every interval written.
+    m_written += sizeof(header) + dataSize;
+    if (!m_evicted || m_written >= DISK_IMAGE_CACHE_EVICT_INTERVAL)
+        evict();
+}
+
+void DiskImageCache::evict()
+{
+    m_evicted = true;
+    m_written = 0;
+
+    QLockFile lock(cacheDir() + "/lock");
+    // another process is evicting.
+    if (!lock.tryLock(0))
+        return;
+
+    QDir dir(cacheDir());
+    // least recently used first.
+    const auto entries = dir.entryInfoList(QStringList()<<"*.img", QDir::Files, QDir::Time | QDir::Reversed);
+    qint64 total = 0;
+    for (auto entry : entries)
+        total += entry.size();
+    if (total <= DISK_IMAGE_CACHE_SIZE)
+        return;
+
+    for (auto entry : entries) {
+        if (total <= DISK_IMAGE_CACHE_SIZE / 4 * 3)
+            break;
+        if (QFile::remove(entry.absoluteFilePath()))
+            total -= entry.size();
+    }
+}
@@ -0,0 +1,75 @@
+/*
+ * Qt5-UKUI's Library
+ *
+ * Copyright (C) 2020, Tianjin KYLIN Information Technology Co., Ltd.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this library.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * Authors: Yue Lan <lanyue@kylinos.cn>
+ *
+ */
+
+#ifndef DISKIMAGECACHE_H
+#define DISKIMAGECACHE_H
+
+#include <QImage>
+#include <QString>
+
+/*!
+ * \brief The DiskImageCache class
+ * \details
+ * A cache of rasterized style assets shared by all applications and kept
+ * across launches, in $XDG_CACHE_HOME/ukui-style. It sits behind the in
+ * memory caches of shadow tiles, nine slice sprites and indicators, so that
+ * a new process starts with the assets painted by the previous ones.
+ *
+ * Files are content addressed, named by a hash of the asset key and the
+ * cache version. The key must describe everything the asset is painted
+ * from, including the device pixel ratio, and must not contain values that
+ * are only meaningful in one process, such as QPalette::cacheKey().
+ *
+ * An entry is a small header followed by the raw pixels, which are read
+ * straight into a new image, no file stays open for a cached image. Entries are written to a temporary file and
+ * renamed, so a reader never sees a partial entry, and entries that do not
+ * match their header are removed. The least recently used entries are
+ * evicted when the cache grows over its size limit, under a lock file so
+ * that only one process evicts at a time.
+ *
+ * Set QT5UKUI_NO_DISK_CACHE to neither read nor write the cache.
+ */
+class DiskImageCache
+{
+public:
+    static DiskImageCache *globalInstance();
+    static QString cacheDir();
+
+    /*!
+     * \brief find
+     * \param key
+     * \param image the cached image.
+     * \return true if the asset was cached.
+     */
+    bool find(const QString &key, QImage *image);
+    void insert(const QString &key, const QImage &image);
+
+private:
+    DiskImageCache() {}
+    QString filePath(const QString &key) const;
+    void evict();
+
+    qint64 m_written = 0;
+    bool m_evicted = false;
+};
+
+#endif // DISKIMAGECACHE_H
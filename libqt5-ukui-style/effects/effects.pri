@@ -2,7 +2,9 @@ INCLUDEPATH += $$PWD
 INCLUDEPATH += $$PWD/..
 
 HEADERS += \
-    $$PWD/highlight-effect.h
+    $$PWD/highlight-effect.h \
+    $$PWD/rounded-rect-region.h
 
 SOURCES += \
-    $$PWD/highlight-effect.cpp
+    $$PWD/highlight-effect.cpp \
+    $$PWD/rounded-rect-region.cpp
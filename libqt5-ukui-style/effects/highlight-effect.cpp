@@ -21,6 +21,7 @@
  */
 
 #include "highlight-effect.h"
+#include "paint-statistics.h"
 
 #include <QAbstractItemView>
 #include <QMenu>
@@ -170,6 +171,8 @@ QPixmap HighLightEffect::generatePixmap(const QPixmap &pixmap, const QStyleOptio
     if (widget && !widget->isEnabled())
         return pixmap;
 
+    PaintStatistics::count(PaintStatistics::HighlightRecolors);
+
     QPixmap target = pixmap;
     bool isPurePixmap = isPixmapPureColor(pixmap);
     if (force) {
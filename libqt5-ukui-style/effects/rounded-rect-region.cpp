@@ -0,0 +1,43 @@
+/*
+ * Qt5-UKUI's Library
+ *
+ * Copyright (C) 2020, Tianjin KYLIN Information Technology Co., Ltd.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this library.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * Authors: Yue Lan <lanyue@kylinos.cn>
+ *
+ */
+
+#include "rounded-rect-region.h"
+
+#include <QPainterPath>
+#include <QCache>
+
+#define ROUNDED_RECT_REGION_CACHE_SIZE 64
+
+QRegion roundedRectRegion(const QRect &rect, qreal xRadius, qreal yRadius)
+{
+    static QCache<QString, QRegion> cache(ROUNDED_RECT_REGION_CACHE_SIZE);
+
+    const QString key = QString("%1x%2_%3_%4").arg(rect.width()).arg(rect.height()).arg(xRadius).arg(yRadius);
+    if (auto region = cache.object(key))
+        return region->translated(rect.topLeft());
+
+    QPainterPath path;
+    path.addRoundedRect(QRect(QPoint(0, 0), rect.size()), xRadius, yRadius);
+    auto region = new QRegion(path.toFillPolygon().toPolygon());
+    cache.insert(key, region);
+    return region->translated(rect.topLeft());
+}
@@ -0,0 +1,42 @@
+/*
+ * Qt5-UKUI's Library
+ *
+ * Copyright (C) 2020, Tianjin KYLIN Information Technology Co., Ltd.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this library.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * Authors: Yue Lan <lanyue@kylinos.cn>
+ *
+ */
+
+#ifndef ROUNDEDRECTREGION_H
+#define ROUNDEDRECTREGION_H
+
+#include <QRegion>
+
+/*!
+ * \brief roundedRectRegion
+ * \param rect
+ * \param xRadius
+ * \param yRadius
+ * \return region of the rounded rect.
+ * \details
+ * flattening the rounded rect path and converting the polygon to a region
+ * are done once for each size and radius, the cached region is translated
+ * to rect's position. Used for masks and blur regions of menus and tooltips,
+ * which are updated whenever they are resized or shown.
+ */
+QRegion roundedRectRegion(const QRect &rect, qreal xRadius, qreal yRadius);
+
+#endif // ROUNDEDRECTREGION_H
@@ -1,7 +1,17 @@
 INCLUDEPATH += $$PWD
 
+# the package version, caches written by another build are discarded.
+BUILD_CHANGELOG = $$cat($$PWD/../debian/changelog, lines)
+BUILD_VERSION = $$first(BUILD_CHANGELOG)
+BUILD_VERSION = $$section(BUILD_VERSION, "(", 1, 1)
+BUILD_VERSION = $$section(BUILD_VERSION, ")", 0, 0)
+isEmpty(BUILD_VERSION): BUILD_VERSION = $$system(date +%s)
+DEFINES += QT5UKUI_BUILD_VERSION='\\"$${BUILD_VERSION}\\"'
+
 include(animations/animations.pri)
 include(settings/settings.pri)
 include(internal-styles/internal-styles.pri)
 include(effects/effects.pri)
 include(gestures/gestures.pri)
+include(statistics/statistics.pri)
+include(cache/cache.pri)
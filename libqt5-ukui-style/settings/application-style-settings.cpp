@@ -22,12 +22,15 @@
 
 #include "application-style-settings.h"
 #include <QApplication>
-#include <QtConcurrent/QtConcurrent>
 #include <QStandardPaths>
 #include <QStyle>
+#include <QTimer>
+#include <QFileInfo>
 
 #include <QFileSystemWatcher>
 
+#define WRITE_BEHIND_DELAY 300
+
 static ApplicationStyleSettings *global_instance = nullptr;
 
 ApplicationStyleSettings *ApplicationStyleSettings::getInstance()
@@ -49,9 +52,7 @@ void ApplicationStyleSettings::setColor(const QPalette::ColorRole &role, const Q
     beginGroup(m_color_group_enum.key(group));
     setValue(m_color_role_enum.key(role), color);
     endGroup();
-    QtConcurrent::run([=](){
-        this->sync();
-    });
+    scheduleSync();
     auto palette = QApplication::palette();
     palette.setColor(group, role, color);
     QApplication::setPalette(palette);
@@ -75,9 +76,7 @@ void ApplicationStyleSettings::setColorStretagy(ApplicationStyleSettings::ColorS
         m_color_stretagy = stretagy;
         setValue("color-stretagy", stretagy);
         Q_EMIT colorStretageChanged(stretagy);
-        QtConcurrent::run([=](){
-            this->sync();
-        });
+        scheduleSync();
     }
 }
 
@@ -87,9 +86,7 @@ void ApplicationStyleSettings::setStyleStretagy(ApplicationStyleSettings::StyleS
         m_style_stretagy = stretagy;
         setValue("style-stretagy", stretagy);
         Q_EMIT styleStretageChanged(stretagy);
-        QtConcurrent::run([=](){
-            this->sync();
-        });
+        scheduleSync();
     }
 }
 
@@ -101,8 +98,8 @@ void ApplicationStyleSettings::setCustomStyle(const QString &style)
 
 void ApplicationStyleSettings::refreshData(bool forceSync)
 {
-    sync();
-    m_custom_palette = QApplication::palette();
+    // writes our pending changes too, and reloads the file.
+    syncNow();
 
     auto color_stretagy = qvariant_cast<ColorStretagy>(value("color-stretagy"));
     if (color_stretagy != m_color_stretagy) {
@@ -124,26 +121,76 @@ void ApplicationStyleSettings::refreshData(bool forceSync)
 
     readPalleteSettings();
 
-    if (forceSync) {
-        QtConcurrent::run([=](){
-            this->sync();
-        });
-    }
+    if (forceSync)
+        scheduleSync();
 }
 
+/*!
+ * \brief ApplicationStyleSettings::readPalleteSettings
+ * \details
+ * only the colors different from the current custom palette are set, colors
+ * removed from the file fall back to the application palette.
+ */
 void ApplicationStyleSettings::readPalleteSettings()
 {
-    for (int i = 0; i < m_color_group_enum.keyCount(); i++) {
-        beginGroup(m_color_group_enum.key(i));
-        for (int j = 0; j < m_color_role_enum.keyCount(); j++) {
-            auto data = value(m_color_role_enum.key(j));
-            if (data.isValid()) {
-                m_custom_palette.setColor(QPalette::ColorGroup(i),
-                                          QPalette::ColorRole(j),
-                                          qvariant_cast<QColor>(data));
-            }
+    QSet<QString> paletteKeys;
+    for (auto groupName : childGroups()) {
+        bool ok = false;
+        int group = m_color_group_enum.keyToValue(groupName.toLatin1().constData(), &ok);
+        if (!ok || group >= QPalette::NColorGroups)
+            continue;
+
+        beginGroup(groupName);
+        for (auto roleName : childKeys()) {
+            int role = m_color_role_enum.keyToValue(roleName.toLatin1().constData(), &ok);
+            if (!ok || role >= QPalette::NColorRoles)
+                continue;
+
+            paletteKeys << groupName + "/" + roleName;
+            QColor color = qvariant_cast<QColor>(value(roleName));
+            if (color.isValid() && m_custom_palette.color(QPalette::ColorGroup(group), QPalette::ColorRole(role)) != color)
+                m_custom_palette.setColor(QPalette::ColorGroup(group), QPalette::ColorRole(role), color);
         }
+        endGroup();
+    }
+
+    const QPalette applicationPalette = QApplication::palette();
+    for (auto key : m_palette_keys - paletteKeys) {
+        auto group = QPalette::ColorGroup(m_color_group_enum.keyToValue(key.section("/", 0, 0).toLatin1().constData()));
+        auto role = QPalette::ColorRole(m_color_role_enum.keyToValue(key.section("/", 1, 1).toLatin1().constData()));
+        m_custom_palette.setColor(group, role, applicationPalette.color(group, role));
+    }
+    m_palette_keys = paletteKeys;
+}
+
+void ApplicationStyleSettings::scheduleSync()
+{
+    if (!m_sync_timer->isActive())
+        m_sync_timer->start();
+}
+
+void ApplicationStyleSettings::syncNow()
+{
+    m_sync_timer->stop();
+    sync();
+    m_last_write = QFileInfo(fileName()).lastModified();
+
+    // the file is replaced by an atomic write, watch the new one.
+    if (!m_watcher->files().contains(fileName()))
+        m_watcher->addPath(fileName());
+}
+
+void ApplicationStyleSettings::onFileChanged()
+{
+    QFileInfo info(fileName());
+    if (info.exists() && info.lastModified() == m_last_write) {
+        // caused by our own write.
+        if (!m_watcher->files().contains(fileName()))
+            m_watcher->addPath(fileName());
+        return;
     }
+
+    refreshData();
 }
 
 ApplicationStyleSettings::ApplicationStyleSettings(QObject *parent) : QSettings(parent)
@@ -167,9 +214,18 @@ ApplicationStyleSettings::ApplicationStyleSettings(QObject *parent) : QSettings(
     m_custom_palette = QApplication::palette();
     readPalleteSettings();
 
-    QFileSystemWatcher *watcher = new QFileSystemWatcher(this);
-    watcher->addPath(fileName());
-    connect(watcher, &QFileSystemWatcher::fileChanged, [=](){
-        refreshData();
+    m_sync_timer = new QTimer(this);
+    m_sync_timer->setSingleShot(true);
+    m_sync_timer->setInterval(WRITE_BEHIND_DELAY);
+    connect(m_sync_timer, &QTimer::timeout, this, &ApplicationStyleSettings::syncNow);
+    // the instance is never deleted, write pending changes before quitting.
+    connect(qApp, &QCoreApplication::aboutToQuit, this, [=](){
+        if (m_sync_timer->isActive())
+            syncNow();
     });
+
+    m_last_write = QFileInfo(fileName()).lastModified();
+    m_watcher = new QFileSystemWatcher(this);
+    m_watcher->addPath(fileName());
+    connect(m_watcher, &QFileSystemWatcher::fileChanged, this, &ApplicationStyleSettings::onFileChanged);
 }
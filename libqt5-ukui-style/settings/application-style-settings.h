@@ -26,8 +26,12 @@
 #include <QSettings>
 #include <QPalette>
 #include <QMetaEnum>
+#include <QDateTime>
+#include <QSet>
 
 class QStyle;
+class QTimer;
+class QFileSystemWatcher;
 
 /*!
  * \brief The ApplicationStyleSettings class
@@ -36,6 +40,11 @@ class QStyle;
  * For example, you can choose the color scheme switch stretagy of an application, hold
  * the color in light or dark, or follow the system's palette.
  *
+ * Changes are written behind: the changes made within a short window are
+ * coalesced and written to the file once, atomically, from the gui thread.
+ * Change notifications caused by our own writes are ignored, external
+ * changes are applied by comparing the file with the current values.
+ *
  * \note
  * This API is unstable, if possible, do not use it.
  */
@@ -81,6 +90,15 @@ protected:
     void refreshData(bool forceSync = false);
     void readPalleteSettings();
 
+    /*!
+     * \brief scheduleSync
+     * write the changes WRITE_BEHIND_DELAY ms later, together with the changes
+     * made until then.
+     */
+    void scheduleSync();
+    void syncNow();
+    void onFileChanged();
+
 private:
     explicit ApplicationStyleSettings(QObject *parent = nullptr);
     ~ApplicationStyleSettings() {}
@@ -92,6 +110,19 @@ private:
     QMetaEnum m_color_group_enum = QMetaEnum::fromType<QPalette::ColorGroup>();
 
     QPalette m_custom_palette;
+    /*!
+     * \brief m_palette_keys
+     * "group/role" of the colors read from the file.
+     */
+    QSet<QString> m_palette_keys;
+
+    QTimer *m_sync_timer = nullptr;
+    QFileSystemWatcher *m_watcher = nullptr;
+    /*!
+     * \brief m_last_write
+     * modification time of the file after our last write.
+     */
+    QDateTime m_last_write;
 };
 
 #endif // APPLICATIONSTYLESETTINGS_H
@@ -52,4 +52,33 @@ static const QStringList blackAppListWithBlurHelper(){
     return l;
 }
 
+/*!
+ * \brief darkPaletteAppList
+ * applications using the dark palette in ukui-default style.
+ */
+static const QStringList darkPaletteAppList(){
+    QStringList l;
+    l<<"ukui-menu";
+    l<<"ukui-panel";
+    l<<"ukui-sidebar";
+    l<<"ukui-volume-control-applet-qt";
+    l<<"ukui-power-manager-tray";
+    l<<"kylin-nm";
+    l<<"ukui-flash-disk";
+//    l<<"ukui-bluetooth";
+    l<<"mktip";
+    return l;
+}
+
+/*!
+ * \brief defaultPaletteAppList
+ * applications always using the light palette.
+ */
+static const QStringList defaultPaletteAppList(){
+    QStringList l;
+    l<<"kybackup";
+    l<<"biometric-manager";
+    return l;
+}
+
 #endif // BLACKLIST_H
@@ -1,9 +1,17 @@
+QT += concurrent
+
 HEADERS += $$PWD/libqt5-ukui-style_global.h \
            $$PWD/ukui-style-settings.h \
-    $$PWD/application-style-settings.h
+    $$PWD/application-style-settings.h \
+    $$PWD/ukui-palette.h \
+    $$PWD/theme-bundle.h \
+    $$PWD/theme-change-transaction.h
 
 SOURCES += $$PWD/ukui-style-settings.cpp \
-    $$PWD/application-style-settings.cpp
+    $$PWD/application-style-settings.cpp \
+    $$PWD/ukui-palette.cpp \
+    $$PWD/theme-bundle.cpp \
+    $$PWD/theme-change-transaction.cpp
 
 INCLUDEPATH += $$PWD/..
 INCLUDEPATH += $$PWD
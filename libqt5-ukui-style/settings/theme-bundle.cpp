@@ -0,0 +1,221 @@
+/*
+ * Qt5-UKUI's Library
+ *
+ * Copyright (C) 2020, Tianjin KYLIN Information Technology Co., Ltd.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this library.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * Authors: Yue Lan <lanyue@kylinos.cn>
+ *
+ */
+
+#include "theme-bundle.h"
+#include "ukui-style-settings.h"
+
+#include <QFile>
+#include <QSaveFile>
+#include <QFileInfo>
+#include <QDir>
+#include <QDataStream>
+#include <QStandardPaths>
+#include <QFont>
+#include <QtConcurrent/QtConcurrent>
+
+#define THEME_BUNDLE_MAGIC "UKUITHM"
+#define THEME_BUNDLE_VERSION 3
+#define THEME_BUNDLE_STREAM_VERSION QDataStream::Qt_5_6
+
+struct ThemeBundleHeader
+{
+    char magic[8];
+    quint32 version;
+    quint32 payloadSize;
+    qint64 schemaStamp;
+    char buildVersion[32];
+};
+
+static ThemeBundle *global_instance = nullptr;
+
+static bool isDisabled()
+{
+    static const bool disabled = qEnvironmentVariableIsSet("QT5UKUI_NO_THEME_BUNDLE");
+    return disabled;
+}
+
+/*!
+ * \brief readBundle
+ * \param values the values of the bundle at path, if it is valid.
+ * \return true if the bundle is of this version and build, and generated
+ * with the installed schemas.
+ */
+static bool readBundle(const QString &path, qint64 schemaStamp, QVariantHash *values)
+{
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly) || file.size() < qint64(sizeof(ThemeBundleHeader)))
+        return false;
+
+    uchar *data = file.map(0, file.size());
+    if (!data)
+        return false;
+
+    bool valid = false;
+    ThemeBundleHeader header;
+    memcpy(&header, data, sizeof(header));
+    if (qstrncmp(header.magic, THEME_BUNDLE_MAGIC, sizeof(header.magic)) == 0
+            && header.version == THEME_BUNDLE_VERSION
+            && header.payloadSize == file.size() - sizeof(header)
+            && header.schemaStamp == schemaStamp
+            && qstrncmp(header.buildVersion, QT5UKUI_BUILD_VERSION, sizeof(header.buildVersion)) == 0) {
+        // read the values in place, without copying the file.
+        const QByteArray payload = QByteArray::fromRawData(reinterpret_cast<const char *>(data + sizeof(header)),
+                                                           int(header.payloadSize));
+        QDataStream in(payload);
+        in.setVersion(THEME_BUNDLE_STREAM_VERSION);
+        in >> *values;
+        valid = in.status() == QDataStream::Ok;
+        if (!valid)
+            values->clear();
+    }
+
+    file.unmap(data);
+    return valid;
+}
+
+static bool writeBundle(const QString &path, qint64 schemaStamp, const QVariantHash &values)
+{
+    // all running applications update the bundle after a change, only the first one writes.
+    QVariantHash current;
+    if (readBundle(path, schemaStamp, &current) && current == values)
+        return true;
+
+    QByteArray payload;
+    QDataStream out(&payload, QIODevice::WriteOnly);
+    out.setVersion(THEME_BUNDLE_STREAM_VERSION);
+    out << values;
+
+    ThemeBundleHeader header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, THEME_BUNDLE_MAGIC, sizeof(THEME_BUNDLE_MAGIC));
+    header.version = THEME_BUNDLE_VERSION;
+    header.payloadSize = quint32(payload.size());
+    header.schemaStamp = schemaStamp;
+    qstrncpy(header.buildVersion, QT5UKUI_BUILD_VERSION, sizeof(header.buildVersion));
+
+    QDir().mkpath(QFileInfo(path).path());
+    QSaveFile file(path);
+    if (!file.open(QIODevice::WriteOnly))
+        return false;
+    file.write(reinterpret_cast<const char *>(&header), sizeof(header));
+    file.write(payload);
+    return file.commit();
+}
+
+ThemeBundle *ThemeBundle::globalInstance()
+{
+    if (!global_instance)
+        global_instance = new ThemeBundle;
+    return global_instance;
+}
+
+QString ThemeBundle::path()
+{
+    return QStandardPaths::writableLocation(QStandardPaths::RuntimeLocation) + "/ukui-style/theme-bundle";
+}
+
+bool ThemeBundle::isValid()
+{
+    if (!m_loaded)
+        load();
+    return m_valid;
+}
+
+QVariant ThemeBundle::value(const QString &key)
+{
+    if (!isValid())
+        return QVariant();
+    return m_values.value(key);
+}
+
+void ThemeBundle::invalidate()
+{
+    m_loaded = true;
+    m_valid = false;
+    m_values.clear();
+}
+
+QStringList ThemeBundle::outdatedSettings()
+{
+    QStringList keys;
+    if (!isValid())
+        return keys;
+
+    auto settings = UKUIStyleSettings::globalInstance();
+    for (auto key : settings->keys()) {
+        if (m_values.value("settings/" + key) != settings->get(key))
+            keys<<key;
+    }
+    return keys;
+}
+
+/*!
+ * \brief ThemeBundle::schemaStamp
+ * \return the modification time of the compiled gsettings schemas, in ms.
+ * \details
+ * the values of org.ukui.style are not part of the validity, they change
+ * with every write of any gsettings key to the dconf database. Changes made
+ * while applications run are written by them, outdatedSettings() finds the
+ * others.
+ */
+qint64 ThemeBundle::schemaStamp()
+{
+    QFileInfo info("/usr/share/glib-2.0/schemas/gschemas.compiled");
+    return info.exists()? info.lastModified().toMSecsSinceEpoch(): 0;
+}
+
+void ThemeBundle::load()
+{
+    m_loaded = true;
+    if (isDisabled())
+        return;
+
+    m_valid = readBundle(path(), schemaStamp(), &m_values);
+}
+
+void ThemeBundle::generate(const QPalette &lightPalette, const QPalette &darkPalette)
+{
+    if (isDisabled() || !UKUIStyleSettings::isSchemaInstalled("org.ukui.style"))
+        return;
+
+    auto settings = UKUIStyleSettings::globalInstance();
+    QVariantHash values;
+    for (auto key : settings->keys())
+        values.insert("settings/" + key, settings->get(key));
+
+    values.insert(THEME_BUNDLE_LIGHT_PALETTE, lightPalette);
+    values.insert(THEME_BUNDLE_DARK_PALETTE, darkPalette);
+
+    const QString fontName = settings->get("systemFont").toString();
+    const double fontSize = settings->get("systemFontSize").toString().toDouble();
+    QFont systemFont;
+    systemFont.setFamily(fontName);
+    systemFont.setPointSizeF(fontSize);
+    QFont fixedFont;
+    fixedFont.setFamily(fontName);
+    fixedFont.setPointSizeF(fontSize * 1.2);
+    values.insert(THEME_BUNDLE_SYSTEM_FONT, systemFont);
+    values.insert(THEME_BUNDLE_FIXED_FONT, fixedFont);
+
+    // the file is compared and committed off the gui thread.
+    QtConcurrent::run(writeBundle, path(), schemaStamp(), values);
+}
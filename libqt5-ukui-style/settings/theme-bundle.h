@@ -0,0 +1,108 @@
+/*
+ * Qt5-UKUI's Library
+ *
+ * Copyright (C) 2020, Tianjin KYLIN Information Technology Co., Ltd.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this library.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * Authors: Yue Lan <lanyue@kylinos.cn>
+ *
+ */
+
+#ifndef THEMEBUNDLE_H
+#define THEMEBUNDLE_H
+
+#include "libqt5-ukui-style_global.h"
+#include <QVariantHash>
+#include <QStringList>
+#include <QPalette>
+
+#define THEME_BUNDLE_LIGHT_PALETTE "palette/light"
+#define THEME_BUNDLE_DARK_PALETTE "palette/dark"
+#define THEME_BUNDLE_SYSTEM_FONT "font/system"
+#define THEME_BUNDLE_FIXED_FONT "font/fixed"
+
+// ms after startup until applications started from a valid bundle watch the settings.
+#define THEME_BUNDLE_WATCH_DELAY 1000
+// ms the settings have to settle after a change before the bundle is written again.
+#define THEME_BUNDLE_UPDATE_DELAY 1000
+
+/*!
+ * \brief The ThemeBundle class
+ * \details
+ * A versioned binary snapshot of what every ukui Qt application works out at
+ * startup: the org.ukui.style values, the resolved light and dark palettes
+ * and the system and fixed fonts. It is mapped read only when the platform
+ * theme or the style is created, and consumers fall back to reading the
+ * settings when it is missing, of another version or build, or generated
+ * with other gsettings schemas.
+ *
+ * Qt5UKUIPlatformTheme keeps the bundle up to date once the application is
+ * running: it regenerates it after org.ukui.style changes, and when the
+ * values it started with are outdated or it had to read the settings. The
+ * file is written off the gui thread, and only when its values changed.
+ *
+ * The file is $XDG_RUNTIME_DIR/ukui-style/theme-bundle, it is replaced
+ * atomically. Set QT5UKUI_NO_THEME_BUNDLE to neither read nor write it.
+ */
+class LIBQT5UKUISTYLESHARED_EXPORT ThemeBundle
+{
+public:
+    static ThemeBundle *globalInstance();
+    static QString path();
+
+    /*!
+     * \brief isValid
+     * \return true if the bundle is of this version and build, and generated
+     * with the installed schemas.
+     */
+    bool isValid();
+    QVariant value(const QString &key);
+    /*!
+     * \brief setting
+     * \param key an org.ukui.style key, in QGSettings' camel case.
+     */
+    QVariant setting(const QString &key) {return value("settings/" + key);}
+
+    /*!
+     * \brief invalidate
+     * forget the values of the bundle, for example when org.ukui.style changes
+     * while the application is running.
+     */
+    void invalidate();
+
+    /*!
+     * \brief outdatedSettings
+     * \return the org.ukui.style keys whose values differ from the bundle's.
+     * It reads the settings, call it after startup.
+     */
+    QStringList outdatedSettings();
+
+    /*!
+     * \brief generate
+     * reads the settings and writes the bundle from them asynchronously.
+     */
+    static void generate(const QPalette &lightPalette, const QPalette &darkPalette);
+
+private:
+    ThemeBundle() {}
+    void load();
+    static qint64 schemaStamp();
+
+    bool m_loaded = false;
+    bool m_valid = false;
+    QVariantHash m_values;
+};
+
+#endif // THEMEBUNDLE_H
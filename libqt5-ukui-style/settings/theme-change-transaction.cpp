@@ -0,0 +1,138 @@
+/*
+ * Qt5-UKUI's Library
+ *
+ * Copyright (C) 2020, Tianjin KYLIN Information Technology Co., Ltd.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this library.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * Authors: Yue Lan <lanyue@kylinos.cn>
+ *
+ */
+
+#include "theme-change-transaction.h"
+
+#include <QApplication>
+#include <QWidget>
+
+#define THEME_CHANGE_COORDINATOR_PROPERTY "ukuiThemeChangeTransaction"
+
+static ThemeChangeTransaction *global_instance = nullptr;
+
+static bool isDisabled()
+{
+    static const bool disabled = qEnvironmentVariableIsSet("QT5UKUI_NO_THEME_TRANSACTION");
+    return disabled;
+}
+
+/// children are repainted with their window, hidden widgets are painted when they are shown.
+static void updateVisibleWindows()
+{
+    for (auto widget : QApplication::topLevelWidgets()) {
+        if (widget->isVisible())
+            widget->update();
+    }
+}
+
+ThemeChangeTransaction::ThemeChangeTransaction(QObject *parent) : QObject(parent)
+{
+    // one event loop turn.
+    m_timer.setSingleShot(true);
+    m_timer.setInterval(0);
+    connect(&m_timer, &QTimer::timeout, this, &ThemeChangeTransaction::commit);
+}
+
+ThemeChangeTransaction *ThemeChangeTransaction::globalInstance()
+{
+    if (!global_instance) {
+        global_instance = new ThemeChangeTransaction(qApp);
+        QObject *coordinator = qApp->property(THEME_CHANGE_COORDINATOR_PROPERTY).value<QObject *>();
+        if (!coordinator) {
+            coordinator = global_instance;
+            qApp->setProperty(THEME_CHANGE_COORDINATOR_PROPERTY, QVariant::fromValue<QObject *>(coordinator));
+        }
+        global_instance->m_coordinator = coordinator;
+        // the coordinator may be of another copy of this class, connect by signature.
+        connect(coordinator, SIGNAL(stageStarted(int)), global_instance, SLOT(applyStage(int)));
+    }
+    return global_instance;
+}
+
+void ThemeChangeTransaction::schedule(Stage stage, const QString &key, QObject *context, const std::function<void()> &apply)
+{
+    if (isDisabled()) {
+        apply();
+        return;
+    }
+
+    auto transaction = globalInstance();
+    transaction->m_work[stage].insert(qMakePair(context, key), Work{context, apply});
+    QMetaObject::invokeMethod(transaction->m_coordinator, "addStage", Q_ARG(int, stage));
+}
+
+void ThemeChangeTransaction::requestRepaint()
+{
+    if (isDisabled()) {
+        updateVisibleWindows();
+        return;
+    }
+
+    QMetaObject::invokeMethod(globalInstance()->m_coordinator, "addRepaint");
+}
+
+void ThemeChangeTransaction::addStage(int stage)
+{
+    m_stages |= 1 << stage;
+    m_timer.start();
+}
+
+void ThemeChangeTransaction::addRepaint()
+{
+    m_repaint = true;
+    m_timer.start();
+}
+
+void ThemeChangeTransaction::commit()
+{
+    // work scheduled while applying goes to the next transaction.
+    const int stages = m_stages;
+    const bool repaint = m_repaint;
+    m_stages = 0;
+    m_repaint = false;
+
+    for (int stage = 0; stage < StageCount; stage++) {
+        if (stages & (1 << stage))
+            Q_EMIT stageStarted(stage);
+    }
+
+    // also the repaints requested by the stages.
+    if (repaint || m_repaint) {
+        m_repaint = false;
+        updateVisibleWindows();
+    }
+
+    Q_EMIT committed();
+}
+
+void ThemeChangeTransaction::applyStage(int stage)
+{
+    if (stage < 0 || stage >= StageCount)
+        return;
+
+    const auto work = m_work[stage];
+    m_work[stage].clear();
+    for (auto it = work.constBegin(); it != work.constEnd(); ++it) {
+        if (it.value().context)
+            it.value().apply();
+    }
+}
@@ -0,0 +1,113 @@
+/*
+ * Qt5-UKUI's Library
+ *
+ * Copyright (C) 2020, Tianjin KYLIN Information Technology Co., Ltd.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this library.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * Authors: Yue Lan <lanyue@kylinos.cn>
+ *
+ */
+
+#ifndef THEMECHANGETRANSACTION_H
+#define THEMECHANGETRANSACTION_H
+
+#include <QObject>
+#include <QTimer>
+#include <QPointer>
+#include <QMap>
+#include <functional>
+
+/*!
+ * \brief The ThemeChangeTransaction class
+ * \details
+ * Switching the desktop theme changes several org.ukui.style keys in a row,
+ * and the platform theme and the style plugins each react to them on their
+ * own. Applied one by one, every key sets the style, palette or font of the
+ * application or updates all widgets, and each of them relayouts and
+ * repaints the whole application.
+ *
+ * Handlers schedule their work for a stage instead. The changes of one event
+ * loop turn are collected into a transaction, which applies the stages in
+ * dependency order, the style first, then the palette, fonts, icon theme and
+ * window effects, and repaints the visible windows once at the end.
+ *
+ * The platform theme and each style plugin are built with their own copy of
+ * this library. The instance of the first copy used is registered on qApp as
+ * the coordinator of the process, the other copies only talk to it through
+ * the meta object system, so that one transaction covers all of them.
+ *
+ * Set QT5UKUI_NO_THEME_TRANSACTION to apply every change immediately.
+ */
+class ThemeChangeTransaction : public QObject
+{
+    Q_OBJECT
+public:
+    enum Stage {
+        Style,
+        Palette,
+        Font,
+        IconTheme,
+        WindowEffects,
+        StageCount
+    };
+    Q_ENUM(Stage)
+
+    /*!
+     * \brief schedule
+     * \param stage
+     * \param key identifies the work of context in a transaction, it is
+     * replaced when the same key is scheduled again.
+     * \param context the work is dropped when context is destroyed.
+     * \param apply the work, it should read the settings when it is called.
+     */
+    static void schedule(Stage stage, const QString &key, QObject *context, const std::function<void()> &apply);
+
+    /*!
+     * \brief requestRepaint
+     * repaint the visible windows once the transaction is applied.
+     */
+    static void requestRepaint();
+
+Q_SIGNALS:
+    void stageStarted(int stage);
+    void committed();
+
+public Q_SLOTS:
+    void addStage(int stage);
+    void addRepaint();
+
+private Q_SLOTS:
+    void commit();
+    void applyStage(int stage);
+
+private:
+    explicit ThemeChangeTransaction(QObject *parent = nullptr);
+    static ThemeChangeTransaction *globalInstance();
+
+    struct Work {
+        QPointer<QObject> context;
+        std::function<void()> apply;
+    };
+    // work scheduled through this copy of the library.
+    QMap<QPair<QObject *, QString>, Work> m_work[StageCount];
+    QObject *m_coordinator = nullptr;
+
+    // state of the coordinator.
+    QTimer m_timer;
+    int m_stages = 0;
+    bool m_repaint = false;
+};
+
+#endif // THEMECHANGETRANSACTION_H
@@ -0,0 +1,166 @@
+/*
+ * Qt5-UKUI's Library
+ *
+ * Copyright (C) 2020, Tianjin KYLIN Information Technology Co., Ltd.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this library.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * Authors: Yue Lan <lanyue@kylinos.cn>
+ *
+ */
+
+#include "ukui-palette.h"
+
+/*!
+ * \brief fusionStandardPalette
+ * \return the palette of QFusionStyle::standardPalette(), it is fixed and
+ * does not need a style to be created.
+ */
+static QPalette fusionStandardPalette()
+{
+    // QStyle::standardPalette(), the base of QCommonStyle.
+    QColor background(0xd4, 0xd0, 0xc8);
+    QPalette palette(Qt::black, background, background.lighter(), background.darker(), Qt::gray, Qt::black, Qt::white);
+    palette.setBrush(QPalette::Disabled, QPalette::WindowText, background.darker());
+    palette.setBrush(QPalette::Disabled, QPalette::Text, background.darker());
+    palette.setBrush(QPalette::Disabled, QPalette::ButtonText, background.darker());
+    palette.setBrush(QPalette::Disabled, QPalette::Base, background);
+
+    palette.setBrush(QPalette::Active, QPalette::Highlight, QColor(48, 140, 198));
+    palette.setBrush(QPalette::Inactive, QPalette::Highlight, QColor(145, 141, 126));
+    palette.setBrush(QPalette::Disabled, QPalette::Highlight, QColor(145, 141, 126));
+
+    background.setRgb(239, 235, 231);
+    const QColor dark = background.darker(150);
+    palette.setBrush(QPalette::Disabled, QPalette::Text, QColor(190, 190, 190));
+    palette.setBrush(QPalette::Window, background);
+    palette.setBrush(QPalette::Mid, background.darker(130));
+    palette.setBrush(QPalette::Light, background.lighter(150));
+    palette.setBrush(QPalette::Active, QPalette::Base, Qt::white);
+    palette.setBrush(QPalette::Inactive, QPalette::Base, Qt::white);
+    palette.setBrush(QPalette::Disabled, QPalette::Base, background);
+    palette.setBrush(QPalette::Midlight, palette.midlight().color().lighter(110));
+    palette.setBrush(QPalette::All, QPalette::Dark, dark);
+    palette.setBrush(QPalette::Disabled, QPalette::Dark, QColor(209, 200, 191).darker(110));
+    palette.setBrush(QPalette::Button, background);
+    palette.setBrush(QPalette::Shadow, dark.darker(135));
+    palette.setBrush(QPalette::Disabled, QPalette::Shadow, dark.darker(135).lighter(150));
+    palette.setBrush(QPalette::HighlightedText, QColor(QRgb(0xffffffff)));
+
+    return palette;
+}
+
+QPalette ukuiStandardPalette(bool dark)
+{
+    // Qt5UKUIStyle is based on fusion.
+    return ukuiStandardPalette(dark, fusionStandardPalette());
+}
+
+QPalette ukuiStandardPalette(bool dark, const QPalette &base)
+{
+    auto palette = base;
+    //ukui-light
+    QColor  window_bg(245 , 245, 245),
+            window_no_bg(237 ,237, 237),
+            base_bg(255, 255, 255),
+            base_no_bg(245, 245, 245),
+            font_bg(0,0,0),
+            font_br_bg(255,255,255),
+            font_di_bg(0, 0, 0, 76),
+            button_bg(230, 230, 230),
+            button_di_bg(233,233,233),
+            highlight_bg(55,144,250),
+            highlight_dis(233, 233, 233),
+            tip_bg(248,248,248),
+            tip_font(22,22,22),
+            alternateBase(248,248,248),
+            midlight_bg(217, 217, 217),
+            midlight_dis(230, 230, 230);
+
+    if (dark) {
+        //ukui-dark
+        window_bg.setRgb(31, 32, 34);
+        window_no_bg.setRgb(26 , 26, 26);
+        base_bg.setRgb(18, 18, 18);
+        base_no_bg.setRgb(28, 28, 28);
+        font_bg.setRgb(255,255,255);
+        font_bg.setAlphaF(0.9);
+        font_br_bg.setRgb(255,255,255);
+        font_br_bg.setAlphaF(0.9);
+        font_di_bg.setRgb(255,255,255);
+        font_di_bg.setAlphaF(0.3);
+        button_bg.setRgb(51, 51, 54);
+        button_di_bg.setRgb(46, 46, 48);
+        highlight_dis.setRgb(71, 71, 71);
+        tip_bg.setRgb(61,61,65);
+        tip_font.setRgb(232,232,232);
+        alternateBase.setRgb(36,35,40);
+        midlight_bg.setRgb(77, 77, 77);
+        midlight_dis.setRgb(64, 64, 64);
+    }
+
+    palette.setBrush(QPalette::Active, QPalette::Window, window_bg);
+    palette.setBrush(QPalette::Inactive, QPalette::Window, window_bg);
+    palette.setBrush(QPalette::Disabled, QPalette::Window, window_no_bg);
+
+    palette.setBrush(QPalette::WindowText,font_bg);
+    palette.setBrush(QPalette::Active,QPalette::WindowText,font_bg);
+    palette.setBrush(QPalette::Inactive,QPalette::WindowText,font_bg);
+    palette.setBrush(QPalette::Disabled,QPalette::WindowText,font_di_bg);
+
+    palette.setBrush(QPalette::Active, QPalette::Base, base_bg);
+    palette.setBrush(QPalette::Inactive, QPalette::Base, base_bg);
+    palette.setBrush(QPalette::Disabled, QPalette::Base, base_no_bg);
+
+    palette.setBrush(QPalette::Text,font_bg);
+    palette.setBrush(QPalette::Active,QPalette::Text,font_bg);
+    palette.setBrush(QPalette::Disabled,QPalette::Text,font_di_bg);
+
+    //Cursor placeholder
+#if (QT_VERSION >= QT_VERSION_CHECK(5,12,0))
+    palette.setBrush(QPalette::PlaceholderText,font_di_bg);
+#endif
+
+    palette.setBrush(QPalette::ToolTipBase,tip_bg);
+    palette.setBrush(QPalette::ToolTipText,tip_font);
+
+    palette.setBrush(QPalette::Active, QPalette::Highlight, highlight_bg);
+    palette.setBrush(QPalette::Inactive, QPalette::Highlight, highlight_bg);
+    palette.setBrush(QPalette::Disabled, QPalette::Highlight, highlight_dis);
+
+    palette.setBrush(QPalette::HighlightedText,font_br_bg);
+
+    palette.setBrush(QPalette::BrightText,font_br_bg);
+    palette.setBrush(QPalette::Active,QPalette::BrightText,font_br_bg);
+    palette.setBrush(QPalette::Inactive,QPalette::BrightText,font_br_bg);
+    palette.setBrush(QPalette::Disabled,QPalette::BrightText,font_di_bg);
+
+    palette.setBrush(QPalette::Active, QPalette::Button, button_bg);
+    palette.setBrush(QPalette::Inactive, QPalette::Button, button_bg);
+    palette.setBrush(QPalette::Disabled, QPalette::Button, button_di_bg);
+
+    palette.setBrush(QPalette::ButtonText,font_bg);
+    palette.setBrush(QPalette::Inactive,QPalette::ButtonText,font_bg);
+    palette.setBrush(QPalette::Disabled,QPalette::ButtonText,font_di_bg);
+
+    palette.setBrush(QPalette::AlternateBase,alternateBase);
+    palette.setBrush(QPalette::Inactive,QPalette::AlternateBase,alternateBase);
+    palette.setBrush(QPalette::Disabled,QPalette::AlternateBase,button_di_bg);
+
+    palette.setBrush(QPalette::Active, QPalette::Midlight, midlight_bg);
+    palette.setBrush(QPalette::Inactive, QPalette::Midlight, midlight_bg);
+    palette.setBrush(QPalette::Disabled, QPalette::Midlight, midlight_dis);
+
+    return palette;
+}
@@ -0,0 +1,48 @@
+/*
+ * Qt5-UKUI's Library
+ *
+ * Copyright (C) 2020, Tianjin KYLIN Information Technology Co., Ltd.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this library.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * Authors: Yue Lan <lanyue@kylinos.cn>
+ *
+ */
+
+#ifndef UKUIPALETTE_H
+#define UKUIPALETTE_H
+
+#include <QPalette>
+
+/*!
+ * \brief ukuiStandardPalette
+ * \param dark ukui-dark or ukui-light colors.
+ * \param base palette of the base style, the roles ukui does not set are
+ * kept from it.
+ * \details
+ * the standard palette of ukui styles. It is shared by Qt5UKUIStyle and the
+ * theme bundle, which stores both variants resolved.
+ */
+QPalette ukuiStandardPalette(bool dark, const QPalette &base);
+
+/*!
+ * \brief ukuiStandardPalette
+ * \param dark ukui-dark or ukui-light colors.
+ * \details
+ * the standard palette of ukui styles on fusion's standard palette, without
+ * creating a style. Used by the platform theme before QApplication has one.
+ */
+QPalette ukuiStandardPalette(bool dark);
+
+#endif // UKUIPALETTE_H
@@ -0,0 +1,162 @@
+/*
+ * Qt5-UKUI's Library
+ *
+ * Copyright (C) 2020, Tianjin KYLIN Information Technology Co., Ltd.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this library.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * Authors: Yue Lan <lanyue@kylinos.cn>
+ *
+ */
+
+#include "paint-statistics.h"
+
+#include <QStyle>
+#include <QMetaEnum>
+#include <QThread>
+#include <QCoreApplication>
+#include <QFile>
+#include <QTextStream>
+#include <QDBusConnection>
+
+#include <algorithm>
+
+#define OBJECT_PATH "/org/ukui/style/PaintStatistics/"
+
+static PaintStatistics *global_instance = nullptr;
+static PaintStatistics::ElementTimer *current_timer = nullptr;
+
+PaintStatistics *PaintStatistics::globalInstance()
+{
+    if (!global_instance)
+        global_instance = new PaintStatistics;
+    return global_instance;
+}
+
+PaintStatistics::PaintStatistics(QObject *parent) : QObject(parent)
+{
+    m_clock.start();
+}
+
+void PaintStatistics::exportOnSessionBus(const QString &component)
+{
+    QDBusConnection::sessionBus().registerObject(OBJECT_PATH + component, this, QDBusConnection::ExportAllSlots);
+}
+
+static const char *elementName(PaintStatistics::ElementKind kind, int element)
+{
+    switch (kind) {
+    case PaintStatistics::Primitive:
+        return QMetaEnum::fromType<QStyle::PrimitiveElement>().valueToKey(element);
+    case PaintStatistics::Control:
+        return QMetaEnum::fromType<QStyle::ControlElement>().valueToKey(element);
+    case PaintStatistics::ComplexControl:
+        return QMetaEnum::fromType<QStyle::ComplexControl>().valueToKey(element);
+    default:
+        return nullptr;
+    }
+}
+
+QString PaintStatistics::dump() const
+{
+    struct Row {
+        QString name;
+        ElementCounter counter;
+    };
+    QList<Row> rows;
+    for (int kind = 0; kind < ElementKindCount; kind++) {
+        for (auto it = m_elements[kind].constBegin(); it != m_elements[kind].constEnd(); ++it) {
+            const char *name = elementName(ElementKind(kind), it.key());
+            rows << Row{name? QString(name): QString("%1:%2").arg(kind).arg(it.key()), it.value()};
+        }
+    }
+    // the most expensive elements first.
+    std::sort(rows.begin(), rows.end(), [](const Row &a, const Row &b) {
+        return a.counter.nsecs > b.counter.nsecs;
+    });
+
+    QString report;
+    QTextStream out(&report);
+    out << "# paint statistics of the last " << m_clock.elapsed() / 1000 << " s\n";
+    out << "# element calls total_ms avg_us\n";
+    for (auto row : rows) {
+        out << row.name << " " << row.counter.calls << " "
+            << QString::number(row.counter.nsecs / 1e6, 'f', 2) << " "
+            << QString::number(row.counter.nsecs / 1e3 / qMax(row.counter.calls, quint64(1)), 'f', 2) << "\n";
+    }
+
+    out << "# counter value\n";
+    QMetaEnum counters = QMetaEnum::fromType<Counter>();
+    for (int i = 0; i < CounterCount; i++)
+        out << counters.valueToKey(i) << " " << m_counters[i].load() << "\n";
+
+    out << "# cache hit_rate\n";
+    for (int i = SpriteCacheHits; i < CounterCount; i += 2) {
+        quint64 hits = m_counters[i].load();
+        quint64 misses = m_counters[i + 1].load();
+        QString name = counters.valueToKey(i);
+        name.chop(4);
+        out << name << " ";
+        if (hits + misses > 0)
+            out << QString::number(100.0 * hits / (hits + misses), 'f', 1) << "%\n";
+        else
+            out << "-\n";
+    }
+
+    return report;
+}
+
+bool PaintStatistics::dumpToFile(const QString &path) const
+{
+    QFile file(path);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate | QIODevice::Text))
+        return false;
+    return file.write(dump().toUtf8()) >= 0;
+}
+
+void PaintStatistics::reset()
+{
+    for (int kind = 0; kind < ElementKindCount; kind++)
+        m_elements[kind].clear();
+    for (int i = 0; i < CounterCount; i++)
+        m_counters[i].store(0);
+    m_clock.restart();
+}
+
+PaintStatistics::ElementTimer::ElementTimer(ElementKind kind, int element)
+    : m_kind(kind),
+      m_element(element)
+{
+    // the statistics might have been created by a worker thread painting first.
+    if (!qApp || QThread::currentThread() != qApp->thread())
+        return;
+    if (current_timer && current_timer->m_kind == kind && current_timer->m_element == element)
+        return;
+
+    m_active = true;
+    m_outer = current_timer;
+    current_timer = this;
+    m_timer.start();
+}
+
+PaintStatistics::ElementTimer::~ElementTimer()
+{
+    if (!m_active)
+        return;
+
+    auto &counter = globalInstance()->m_elements[m_kind][m_element];
+    counter.calls++;
+    counter.nsecs += m_timer.nsecsElapsed();
+    current_timer = m_outer;
+}
@@ -0,0 +1,156 @@
+/*
+ * Qt5-UKUI's Library
+ *
+ * Copyright (C) 2020, Tianjin KYLIN Information Technology Co., Ltd.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this library.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * Authors: Yue Lan <lanyue@kylinos.cn>
+ *
+ */
+
+#ifndef PAINTSTATISTICS_H
+#define PAINTSTATISTICS_H
+
+#include <QObject>
+#include <QHash>
+#include <QAtomicInteger>
+#include <QElapsedTimer>
+
+/*!
+ * \brief The PaintStatistics class
+ * \details
+ * Counters of the style's painting, always compiled in and cheap enough to
+ * be always on. For each primitive, control and complex control the calls
+ * and the accumulated time are counted, time of an element includes the
+ * elements it paints through the style. Besides that, HighLightEffect
+ * recolors, shadow generations, blur region writes, animation ticks and the
+ * hits and misses of the style's caches are counted.
+ *
+ * Element timings are only taken in the gui thread, painting of other
+ * threads is not counted.
+ *
+ * The statistics are exported on the session bus connection of the
+ * application, at /org/ukui/style/PaintStatistics/<component> with interface
+ * org.ukui.style.PaintStatistics, for example:
+ *
+ * qdbus :1.42 /org/ukui/style/PaintStatistics/style org.ukui.style.PaintStatistics.dump
+ *
+ * dump() returns a text report, dumpToFile() writes it to a file and
+ * reset() starts counting again.
+ */
+class PaintStatistics : public QObject
+{
+    Q_OBJECT
+    Q_CLASSINFO("D-Bus Interface", "org.ukui.style.PaintStatistics")
+public:
+    enum ElementKind {
+        Primitive,
+        Control,
+        ComplexControl,
+        ElementKindCount
+    };
+
+    /*!
+     * \brief The Counter enum
+     * \details
+     * a cache's miss counter always follows its hit counter.
+     */
+    enum Counter {
+        HighlightRecolors,
+        ShadowGenerations,
+        BlurRegionWrites,
+        AnimationTicks,
+        ProgressClockTicks,
+        SpriteCacheHits,
+        SpriteCacheMisses,
+        IndicatorCacheHits,
+        IndicatorCacheMisses,
+        TextLayoutCacheHits,
+        TextLayoutCacheMisses,
+        PictureCacheHits,
+        PictureCacheMisses,
+        SubRectMemoHits,
+        SubRectMemoMisses,
+        DialLinesCacheHits,
+        DialLinesCacheMisses,
+        IconSizeCacheHits,
+        IconSizeCacheMisses,
+        DiskCacheHits,
+        DiskCacheMisses,
+        CounterCount
+    };
+    Q_ENUM(Counter)
+
+    static PaintStatistics *globalInstance();
+
+    static void count(Counter counter) {
+        globalInstance()->m_counters[counter].fetchAndAddRelaxed(1);
+    }
+    /*!
+     * \brief countCache
+     * \param hits the hit counter of a cache.
+     * \param hit
+     */
+    static void countCache(Counter hits, bool hit) {
+        count(hit? hits: Counter(hits + 1));
+    }
+
+    /*!
+     * \brief exportOnSessionBus
+     * \param component the last element of the object path.
+     */
+    void exportOnSessionBus(const QString &component);
+
+    /*!
+     * \brief The ElementTimer class
+     * \details
+     * Counts one painting of an element in its scope. An element painted
+     * again inside its own painting, for example into a recorded picture,
+     * is counted once.
+     */
+    class ElementTimer
+    {
+    public:
+        ElementTimer(ElementKind kind, int element);
+        ~ElementTimer();
+
+    private:
+        ElementKind m_kind;
+        int m_element;
+        bool m_active = false;
+        ElementTimer *m_outer = nullptr;
+        QElapsedTimer m_timer;
+    };
+
+public Q_SLOTS:
+    QString dump() const;
+    bool dumpToFile(const QString &path) const;
+    void reset();
+
+protected:
+    explicit PaintStatistics(QObject *parent = nullptr);
+
+private:
+    struct ElementCounter {
+        quint64 calls = 0;
+        qint64 nsecs = 0;
+    };
+
+    QHash<int, ElementCounter> m_elements[ElementKindCount];
+    QAtomicInteger<quint64> m_counters[CounterCount];
+    QElapsedTimer m_clock;
+};
+
+#endif // PAINTSTATISTICS_H
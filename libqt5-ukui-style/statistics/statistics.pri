@@ -0,0 +1,10 @@
+QT += dbus
+
+INCLUDEPATH += $$PWD
+INCLUDEPATH += $$PWD/..
+
+HEADERS += \
+    $$PWD/paint-statistics.h
+
+SOURCES += \
+    $$PWD/paint-statistics.cpp
@@ -0,0 +1,123 @@
+/*
+ * Qt5-UKUI's Library
+ *
+ * Copyright (C) 2020, Tianjin KYLIN Information Technology Co., Ltd.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this library.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * Authors: Yue Lan <lanyue@kylinos.cn>
+ *
+ */
+
+#include "file-icon-provider.h"
+
+#include <QFileInfo>
+#include <QMutexLocker>
+
+#include <sys/stat.h>
+
+// the caches are dropped when they grow over these.
+#define SUFFIX_TYPE_CACHE_SIZE 4096
+#define CONTENT_TYPE_CACHE_SIZE 4096
+
+static FileIconProvider *global_instance = nullptr;
+
+FileIconProvider *FileIconProvider::globalInstance()
+{
+    if (!global_instance)
+        global_instance = new FileIconProvider;
+    return global_instance;
+}
+
+QIcon FileIconProvider::icon(const QFileInfo &fileInfo)
+{
+    QMutexLocker locker(&m_mutex);
+
+    if (fileInfo.isDir())
+        return iconForMimeType("inode/directory");
+
+    QString mimeType;
+    if (fileInfo.isFile()) {
+        const QString suffix = fileInfo.suffix().toLower();
+        const QString completeSuffix = fileInfo.completeSuffix().toLower();
+        // "tar.gz" is more specific than "gz".
+        if (suffix != completeSuffix) {
+            const int dot = completeSuffix.lastIndexOf('.', completeSuffix.length() - suffix.length() - 2);
+            const QString doubleSuffix = completeSuffix.mid(dot + 1);
+            const QString doubleSuffixType = mimeTypeForSuffix(doubleSuffix);
+            if (!doubleSuffixType.isEmpty() && doubleSuffixType != mimeTypeForSuffix(suffix))
+                mimeType = doubleSuffixType;
+        }
+        if (mimeType.isEmpty() && !suffix.isEmpty())
+            mimeType = mimeTypeForSuffix(suffix);
+    }
+
+    // no suffix, an ambiguous one, or a special file.
+    if (mimeType.isEmpty())
+        mimeType = mimeTypeForContent(fileInfo);
+
+    return iconForMimeType(mimeType);
+}
+
+QString FileIconProvider::mimeTypeForSuffix(const QString &suffix)
+{
+    auto it = m_suffix_types.constFind(suffix);
+    if (it != m_suffix_types.constEnd())
+        return it.value();
+
+    const QList<QMimeType> types = m_mime_database.mimeTypesForFileName("file." + suffix);
+    const QString mimeType = types.count() == 1? types.first().name(): QString();
+    if (m_suffix_types.size() >= SUFFIX_TYPE_CACHE_SIZE)
+        m_suffix_types.clear();
+    m_suffix_types.insert(suffix, mimeType);
+    return mimeType;
+}
+
+QString FileIconProvider::mimeTypeForContent(const QFileInfo &fileInfo)
+{
+    const QString path = fileInfo.absoluteFilePath();
+    struct stat st;
+    const bool statted = ::stat(QFile::encodeName(path).constData(), &st) == 0;
+    if (statted) {
+        auto it = m_content_types.constFind(path);
+        if (it != m_content_types.constEnd() && it.value().inode == quint64(st.st_ino) && it.value().mtime == qint64(st.st_mtime))
+            return it.value().mimeType;
+    }
+
+    const QString mimeType = m_mime_database.mimeTypeForFile(fileInfo).name();
+    if (statted) {
+        if (m_content_types.size() >= CONTENT_TYPE_CACHE_SIZE)
+            m_content_types.clear();
+        m_content_types.insert(path, ContentEntry{quint64(st.st_ino), qint64(st.st_mtime), mimeType});
+    }
+    return mimeType;
+}
+
+QIcon FileIconProvider::iconForMimeType(const QString &mimeType)
+{
+    // the fallbacks below are resolved once, for the theme current then.
+    if (m_icon_theme != QIcon::themeName()) {
+        m_icon_theme = QIcon::themeName();
+        m_icons.clear();
+    }
+
+    auto it = m_icons.constFind(mimeType);
+    if (it != m_icons.constEnd())
+        return it.value();
+
+    const QMimeType type = m_mime_database.mimeTypeForName(mimeType);
+    QIcon icon = QIcon::fromTheme(type.iconName(), QIcon::fromTheme(type.genericIconName(), QIcon::fromTheme("unknown")));
+    m_icons.insert(mimeType, icon);
+    return icon;
+}
@@ -0,0 +1,78 @@
+/*
+ * Qt5-UKUI's Library
+ *
+ * Copyright (C) 2020, Tianjin KYLIN Information Technology Co., Ltd.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this library.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * Authors: Yue Lan <lanyue@kylinos.cn>
+ *
+ */
+
+#ifndef FILEICONPROVIDER_H
+#define FILEICONPROVIDER_H
+
+#include <QIcon>
+#include <QHash>
+#include <QMutex>
+#include <QMimeDatabase>
+
+class QFileInfo;
+
+/*!
+ * \brief The FileIconProvider class
+ * \details
+ * Themed icons of files for Qt5UKUIPlatformTheme::fileIcon(), resolved by
+ * MIME type.
+ *
+ * The MIME type of a regular file is looked up by its suffix and cached per
+ * suffix, "tar.gz" style double suffixes are checked first. The content of a
+ * file is only read when its name does not tell the type, for files without
+ * a known suffix and for special files. Those are cached per path and
+ * validated with the inode and modification time. Icons are cached per MIME
+ * type, so all files of a type share one QIcon, until the icon theme changes.
+ *
+ * QFileSystemModel asks for icons from its gatherer thread, the caches are
+ * guarded by a mutex.
+ */
+class FileIconProvider
+{
+public:
+    static FileIconProvider *globalInstance();
+
+    QIcon icon(const QFileInfo &fileInfo);
+
+private:
+    FileIconProvider() {}
+
+    QString mimeTypeForSuffix(const QString &suffix);
+    QString mimeTypeForContent(const QFileInfo &fileInfo);
+    QIcon iconForMimeType(const QString &mimeType);
+
+    struct ContentEntry {
+        quint64 inode;
+        qint64 mtime;
+        QString mimeType;
+    };
+
+    QMutex m_mutex;
+    QMimeDatabase m_mime_database;
+    // an empty type is a suffix that needs the content.
+    QHash<QString, QString> m_suffix_types;
+    QHash<QString, ContentEntry> m_content_types;
+    QHash<QString, QIcon> m_icons;
+    QString m_icon_theme;
+};
+
+#endif // FILEICONPROVIDER_H
@@ -0,0 +1,80 @@
+/*
+ * Qt5-UKUI's Library
+ *
+ * Copyright (C) 2020, Tianjin KYLIN Information Technology Co., Ltd.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this library.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * Authors: Yue Lan <lanyue@kylinos.cn>
+ *
+ */
+
+#include "font-family-index.h"
+
+#include <QtConcurrent/QtConcurrent>
+#include <QMutexLocker>
+
+#include <fontconfig/fontconfig.h>
+
+static FontFamilyIndex *global_instance = nullptr;
+
+FontFamilyIndex *FontFamilyIndex::globalInstance()
+{
+    if (!global_instance)
+        global_instance = new FontFamilyIndex;
+    return global_instance;
+}
+
+QFuture<bool> FontFamilyIndex::lookup(const QString &family)
+{
+    return QtConcurrent::run([=]() {
+        return contains(family);
+    });
+}
+
+bool FontFamilyIndex::contains(const QString &family)
+{
+    QMutexLocker locker(&m_mutex);
+    // FcConfigUptoDate() compares the configuration files and font directories with their last scan.
+    if (!m_config || !FcConfigUptoDate(m_config))
+        rebuild();
+    return m_families.contains(family);
+}
+
+void FontFamilyIndex::rebuild()
+{
+    m_families.clear();
+
+    // a configuration of our own, the default one belongs to the gui thread.
+    if (m_config)
+        FcConfigDestroy(m_config);
+    m_config = FcInitLoadConfigAndFonts();
+    if (!m_config)
+        return;
+
+    FcPattern *pattern = FcPatternCreate();
+    FcObjectSet *objects = FcObjectSetBuild(FC_FAMILY, nullptr);
+    FcFontSet *fonts = FcFontList(m_config, pattern, objects);
+    if (fonts) {
+        for (int i = 0; i < fonts->nfont; i++) {
+            // all names of the family, including the localized ones.
+            FcChar8 *family = nullptr;
+            for (int n = 0; FcPatternGetString(fonts->fonts[i], FC_FAMILY, n, &family) == FcResultMatch; n++)
+                m_families.insert(QString::fromUtf8(reinterpret_cast<const char *>(family)));
+        }
+        FcFontSetDestroy(fonts);
+    }
+    FcObjectSetDestroy(objects);
+    FcPatternDestroy(pattern);
+}
@@ -0,0 +1,71 @@
+/*
+ * Qt5-UKUI's Library
+ *
+ * Copyright (C) 2020, Tianjin KYLIN Information Technology Co., Ltd.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this library.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * Authors: Yue Lan <lanyue@kylinos.cn>
+ *
+ */
+
+#ifndef FONTFAMILYINDEX_H
+#define FONTFAMILYINDEX_H
+
+#include <QFuture>
+#include <QMutex>
+#include <QSet>
+#include <QString>
+
+typedef struct _FcConfig FcConfig;
+
+/*!
+ * \brief The FontFamilyIndex class
+ * \details
+ * A hashed index of the installed font families, to check a system font
+ * change without enumerating QFontDatabase::families() on the gui thread,
+ * which takes a long time with large CJK font sets.
+ *
+ * The index is read from fontconfig when it is first used, and read again
+ * only when fontconfig's configuration or font directories change. Lookups
+ * run on a worker thread, with a fontconfig configuration of their own so
+ * that the default one used by the gui thread is never touched.
+ */
+class FontFamilyIndex
+{
+public:
+    static FontFamilyIndex *globalInstance();
+
+    /*!
+     * \brief lookup
+     * \return a future of whether family is installed.
+     */
+    QFuture<bool> lookup(const QString &family);
+
+    /*!
+     * \brief contains
+     * thread safe, reads the index when it is missing or out of date.
+     */
+    bool contains(const QString &family);
+
+private:
+    FontFamilyIndex() {}
+    void rebuild();
+
+    QMutex m_mutex;
+    QSet<QString> m_families;
+    FcConfig *m_config = nullptr;
+};
+
+#endif // FONTFAMILYINDEX_H
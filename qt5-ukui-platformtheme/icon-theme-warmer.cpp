@@ -0,0 +1,243 @@
+/*
+ * Qt5-UKUI's Library
+ *
+ * Copyright (C) 2020, Tianjin KYLIN Information Technology Co., Ltd.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this library.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * Authors: Yue Lan <lanyue@kylinos.cn>
+ *
+ */
+
+#include "icon-theme-warmer.h"
+
+#include <QtConcurrent/QtConcurrent>
+#include <QApplication>
+#include <QWidget>
+#include <QAbstractButton>
+#include <QAction>
+#include <QStyle>
+#include <QIcon>
+#include <QFile>
+#include <QFileInfo>
+#include <QSettings>
+#include <QSet>
+
+#define DEFAULT_ICON_SIZES 16 << 24 << 32
+
+/*!
+ * \brief style_icon_names
+ * icons Qt5UKUIStyle paints by name, besides its standard icons.
+ */
+static const QStringList style_icon_names = {
+    "window-close-symbolic",
+    "ukui-up-symbolic",
+    "ukui-down-symbolic",
+    "ukui-start-symbolic",
+    "ukui-end-symbolic",
+    "dialog-ok"
+};
+
+struct IconThemeDirectory
+{
+    QString path;
+    int size = 0;
+    int minSize = 0;
+    int maxSize = 0;
+    bool scalable = false;
+};
+
+static QStringList themeChain(const QString &iconTheme, const QStringList &searchPaths)
+{
+    QStringList chain;
+    QStringList queue = QStringList()<<iconTheme;
+    while (!queue.isEmpty()) {
+        const QString theme = queue.takeFirst();
+        if (theme.isEmpty() || chain.contains(theme))
+            continue;
+        chain<<theme;
+        for (auto searchPath : searchPaths) {
+            const QString index = searchPath + "/" + theme + "/index.theme";
+            if (QFile::exists(index)) {
+                QSettings settings(index, QSettings::IniFormat);
+                queue<<settings.value("Icon Theme/Inherits").toStringList();
+                break;
+            }
+        }
+    }
+    if (!chain.contains("hicolor"))
+        chain<<"hicolor";
+    return chain;
+}
+
+static QList<IconThemeDirectory> themeDirectories(const QString &iconTheme, const QStringList &searchPaths)
+{
+    QList<IconThemeDirectory> directories;
+    for (auto searchPath : searchPaths) {
+        const QString themePath = searchPath + "/" + iconTheme;
+        const QString index = themePath + "/index.theme";
+        if (!QFile::exists(index))
+            continue;
+
+        QSettings settings(index, QSettings::IniFormat);
+        for (auto subdir : settings.value("Icon Theme/Directories").toStringList()) {
+            settings.beginGroup(subdir);
+            IconThemeDirectory directory;
+            directory.path = themePath + "/" + subdir;
+            directory.size = settings.value("Size").toInt();
+            directory.scalable = settings.value("Type").toString() == "Scalable";
+            directory.minSize = settings.value("MinSize", directory.size).toInt();
+            directory.maxSize = settings.value("MaxSize", directory.size).toInt();
+            settings.endGroup();
+            directories<<directory;
+        }
+    }
+    return directories;
+}
+
+/*!
+ * \brief findIconFile
+ * \return the file of the best matching directory, the icon of the exact
+ * size or a scalable one that covers it, otherwise the first one found.
+ */
+static QString findIconFile(const QList<IconThemeDirectory> &directories, const QString &name, int size)
+{
+    QString fallback;
+    for (auto directory : directories) {
+        for (auto suffix : {".png", ".svg"}) {
+            const QString file = directory.path + "/" + name + suffix;
+            if (!QFileInfo::exists(file))
+                continue;
+            if (directory.size == size || (directory.scalable && directory.minSize <= size && size <= directory.maxSize))
+                return file;
+            if (fallback.isEmpty())
+                fallback = file;
+        }
+    }
+    return fallback;
+}
+
+static void warmIconTheme(const QString &iconTheme, const QStringList &searchPaths,
+                          const QStringList &names, const QList<int> &sizes)
+{
+    QList<QList<IconThemeDirectory>> chain;
+    for (auto theme : themeChain(iconTheme, searchPaths))
+        chain<<themeDirectories(theme, searchPaths);
+
+    for (auto name : names) {
+        for (auto size : sizes) {
+            // same fallback as QIcon::fromTheme(), "a-b-c" falls back to "a-b" and "a".
+            QString iconName = name;
+            QString file;
+            while (file.isEmpty() && !iconName.isEmpty()) {
+                for (auto directories : chain) {
+                    file = findIconFile(directories, iconName, size);
+                    if (!file.isEmpty())
+                        break;
+                }
+                const int dash = iconName.lastIndexOf('-');
+                iconName = dash > 0? iconName.left(dash): QString();
+            }
+            if (file.isEmpty())
+                break;
+
+            // only read, decoding here would be thrown away.
+            QFile iconFile(file);
+            if (iconFile.open(QIODevice::ReadOnly))
+                iconFile.readAll();
+        }
+    }
+}
+
+IconThemeWarmer::IconThemeWarmer(QObject *parent) : QObject(parent)
+{
+    connect(&m_watcher, &QFutureWatcher<void>::finished, this, [=]() {
+        const QString theme = m_current_theme;
+        if (!m_pending_theme.isEmpty()) {
+            const QString pending = m_pending_theme;
+            m_pending_theme.clear();
+            warm(pending);
+            return;
+        }
+        Q_EMIT finished(theme);
+    });
+}
+
+void IconThemeWarmer::warm(const QString &iconTheme)
+{
+    if (m_watcher.isRunning()) {
+        m_pending_theme = iconTheme;
+        return;
+    }
+
+    QStringList names;
+    QList<int> sizes;
+    collectIconsInUse(&names, &sizes);
+
+    m_current_theme = iconTheme;
+    m_watcher.setFuture(QtConcurrent::run(warmIconTheme, iconTheme, QIcon::themeSearchPaths(), names, sizes));
+}
+
+void IconThemeWarmer::collectIconsInUse(QStringList *names, QList<int> *sizes) const
+{
+    QSet<QString> iconNames;
+    QSet<int> iconSizes;
+    auto addIcon = [&](const QIcon &icon) {
+        if (!icon.name().isEmpty())
+            iconNames<<icon.name();
+    };
+
+    addIcon(qApp->windowIcon());
+    for (auto window : QApplication::topLevelWidgets()) {
+        if (!window->isVisible())
+            continue;
+        addIcon(window->windowIcon());
+        for (auto widget : window->findChildren<QWidget *>()) {
+            if (!widget->isVisible())
+                continue;
+            if (auto button = qobject_cast<QAbstractButton *>(widget)) {
+                addIcon(button->icon());
+                iconSizes<<button->iconSize().width();
+            }
+            for (auto action : widget->actions())
+                addIcon(action->icon());
+        }
+    }
+
+    // the standard icons only change with the style.
+    static QStringList standardIconNames;
+    static const QStyle *standardIconStyle = nullptr;
+    if (standardIconStyle != qApp->style()) {
+        standardIconStyle = qApp->style();
+        standardIconNames.clear();
+        for (int i = QStyle::SP_TitleBarMenuButton; i <= QStyle::SP_LineEditClearButton; i++) {
+            const QString name = qApp->style()->standardIcon(QStyle::StandardPixmap(i)).name();
+            if (!name.isEmpty())
+                standardIconNames<<name;
+        }
+    }
+    for (auto name : standardIconNames + style_icon_names)
+        iconNames<<name;
+
+    const qreal ratio = qApp->devicePixelRatio();
+    for (auto size : QList<int>()<<DEFAULT_ICON_SIZES)
+        iconSizes<<size;
+
+    *names = iconNames.values();
+    sizes->clear();
+    for (auto size : iconSizes) {
+        if (size > 0)
+            *sizes<<qRound(size * ratio);
+    }
+}
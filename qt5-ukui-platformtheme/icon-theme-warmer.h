@@ -0,0 +1,68 @@
+/*
+ * Qt5-UKUI's Library
+ *
+ * Copyright (C) 2020, Tianjin KYLIN Information Technology Co., Ltd.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this library.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * Authors: Yue Lan <lanyue@kylinos.cn>
+ *
+ */
+
+#ifndef ICONTHEMEWARMER_H
+#define ICONTHEMEWARMER_H
+
+#include <QObject>
+#include <QFutureWatcher>
+#include <QStringList>
+
+/*!
+ * \brief The IconThemeWarmer class
+ * \details
+ * Prepares an icon theme switch off the gui thread. The icons in use, that
+ * is the window icons, the icons of visible buttons and actions and the
+ * style's standard icons, are looked up in the new theme and its inherited
+ * themes at the sizes in use, and their files are read on a worker thread.
+ * The gui thread then finds the theme directories and files cached by the
+ * system when it loads them after the switch.
+ *
+ * The icons are not decoded, QIcon caches are only usable from the gui
+ * thread and an image decoded here could not be handed to them.
+ */
+class IconThemeWarmer : public QObject
+{
+    Q_OBJECT
+public:
+    explicit IconThemeWarmer(QObject *parent = nullptr);
+
+    /*!
+     * \brief warm
+     * \param iconTheme
+     * start warming iconTheme, finished() is emitted when it is done. A theme
+     * requested while another one is warmed replaces it.
+     */
+    void warm(const QString &iconTheme);
+
+Q_SIGNALS:
+    void finished(const QString &iconTheme);
+
+private:
+    void collectIconsInUse(QStringList *names, QList<int> *sizes) const;
+
+    QFutureWatcher<void> m_watcher;
+    QString m_current_theme;
+    QString m_pending_theme;
+};
+
+#endif // ICONTHEMEWARMER_H
@@ -24,9 +24,17 @@
 #include <QStandardPaths>
 #include "qt5-ukui-platform-theme.h"
 #include "ukui-style-settings.h"
+#include "theme-bundle.h"
+#include "ukui-palette.h"
+#include "black-list.h"
+#include "theme-change-transaction.h"
+#include "icon-theme-warmer.h"
+#include "font-family-index.h"
+#include "file-icon-provider.h"
 #include "highlight-effect.h"
 
 #include <QFontDatabase>
+#include <QFutureWatcher>
 #include <QApplication>
 #include <QTimer>
 
@@ -51,19 +59,28 @@ Qt5UKUIPlatformTheme::Qt5UKUIPlatformTheme(const QStringList &args)
 {
     //FIXME:
     Q_UNUSED(args)
-    if (QGSettings::isSchemaInstalled("org.ukui.style")) {
-        auto settings = UKUIStyleSettings::globalInstance();
+    updatePalette();
 
+    if (QGSettings::isSchemaInstalled("org.ukui.style")) {
         //set font
-        auto fontName = settings->get("systemFont").toString();
-        auto fontSize = settings->get("systemFontSize").toString().toDouble();
-        if (qApp->property("noChangeSystemFontSize").isValid() && qApp->property("noChangeSystemFontSize").toBool())
-            fontSize = 11;
-        m_system_font.setFamily(fontName);
-        m_system_font.setPointSizeF(fontSize);
+        auto bundle = ThemeBundle::globalInstance();
+        if (bundle->isValid()) {
+            m_system_font = qvariant_cast<QFont>(bundle->value(THEME_BUNDLE_SYSTEM_FONT));
+            m_fixed_font = qvariant_cast<QFont>(bundle->value(THEME_BUNDLE_FIXED_FONT));
+        } else {
+            auto settings = UKUIStyleSettings::globalInstance();
+            auto fontName = settings->get("systemFont").toString();
+            auto fontSize = settings->get("systemFontSize").toString().toDouble();
+            m_system_font.setFamily(fontName);
+            m_system_font.setPointSizeF(fontSize);
 
-        m_fixed_font.setFamily(fontName);
-        m_fixed_font.setPointSizeF(fontSize*1.2);
+            m_fixed_font.setFamily(fontName);
+            m_fixed_font.setPointSizeF(fontSize*1.2);
+        }
+        if (qApp->property("noChangeSystemFontSize").isValid() && qApp->property("noChangeSystemFontSize").toBool()) {
+            m_system_font.setPointSizeF(11);
+            m_fixed_font.setPointSizeF(11*1.2);
+        }
 
         /*!
          * \bug
@@ -73,58 +90,200 @@ Qt5UKUIPlatformTheme::Qt5UKUIPlatformTheme(const QStringList &args)
          */
         QApplication::setFont(m_system_font);
 
-        connect(settings, &QGSettings::changed, this, [=](const QString &key){
-            if (key == "iconThemeName") {
+        m_icon_theme_warmer = new IconThemeWarmer(this);
+        connect(m_icon_theme_warmer, &IconThemeWarmer::finished, this, [=](const QString &icontheme) {
+            // a newer theme requested in the meantime replaces this one.
+            ThemeChangeTransaction::schedule(ThemeChangeTransaction::IconTheme, "iconThemeName", this, [=]() {
+                QIcon::setThemeName(icontheme);
+
+                QIcon icon = qApp->windowIcon();
+                qApp->setWindowIcon(QIcon::fromTheme(icon.name()));
+                // repaint new themed icons, hidden widgets paint them when they are shown.
+                ThemeChangeTransaction::requestRepaint();
+            });
+        });
+
+        // the settings are only needed for changes when the bundle has the values.
+        if (bundle->isValid()) {
+            // there is no event dispatcher for timers yet, start it from the event loop.
+            QTimer::singleShot(0, this, [=]() {
+                QTimer::singleShot(THEME_BUNDLE_WATCH_DELAY, this, &Qt5UKUIPlatformTheme::watchSettings);
+            });
+        } else {
+            watchSettings();
+        }
+    }
+}
+
+/*!
+ * \brief Qt5UKUIPlatformTheme::watchSettings
+ * \details
+ * connects to org.ukui.style changes, and keeps the theme bundle up to date
+ * for the applications started next. An application started from the bundle
+ * calls this after startup, it applies the settings changed since the bundle
+ * was written.
+ */
+void Qt5UKUIPlatformTheme::watchSettings()
+{
+    auto settings = UKUIStyleSettings::globalInstance();
+    auto bundle = ThemeBundle::globalInstance();
+
+    m_bundle_timer = new QTimer(this);
+    m_bundle_timer->setSingleShot(true);
+    m_bundle_timer->setInterval(THEME_BUNDLE_UPDATE_DELAY);
+    connect(m_bundle_timer, &QTimer::timeout, this, [=]() {
+        ThemeBundle::generate(ukuiStandardPalette(false), ukuiStandardPalette(true));
+    });
+
+    auto onSettingsChanged = [=](const QString &key) {
+        // the running applications write the bundle again once the changes settle.
+        bundle->invalidate();
+        m_bundle_timer->start();
+
+        // QApplication::setStyle() takes the system palette from us again.
+        if (key == "styleName")
+            updatePalette();
+
+        if (key == "iconThemeName") {
+            ThemeChangeTransaction::schedule(ThemeChangeTransaction::IconTheme, key, this, [=]() {
                 QString icontheme = settings->get("icon-theme-name").toString();
                 if (icontheme == "ukui-icon-theme-default" || icontheme == "ukui")
                     icontheme = "ukui";
                 else if (icontheme == "ukui-icon-theme-classical" || icontheme == "ukui-classical")
                     icontheme = "ukui-classical";
 
-                QIcon::setThemeName(icontheme);
+                // the theme is set once the icons in use are warmed.
+                m_icon_theme_warmer->warm(icontheme);
+            });
+        }
 
-                QIcon icon = qApp->windowIcon();
-                qApp->setWindowIcon(QIcon::fromTheme(icon.name()));
-                // update all widgets for repaint new themed icons.
-                for (auto widget : QApplication::allWidgets()) {
-                    widget->update();
-                }
-            }
-
-            if (key == "systemFont") {
-                QString font = settings->get("system-font").toString();
-                QFontDatabase db;
-                if (db.families().contains(font)) {
-                    QFont oldFont = QApplication::font();
-                    m_system_font.setFamily(font);
-                    m_fixed_font.setFamily(font);
-                    oldFont.setFamily(font);
-                    QApplication::setFont(oldFont);
-                }
-            }
-            if (key == "systemFontSize") {
-                if (qApp->property("noChangeSystemFontSize").isValid() && qApp->property("noChangeSystemFontSize").toBool())
-                    return;
-                double fontSize = settings->get("system-font-size").toString().toDouble();
-                if (fontSize > 0) {
-                    QFont oldFont = QApplication::font();
-                    m_system_font.setPointSize(fontSize);
-                    m_fixed_font.setPointSize(fontSize*1.2);
-                    oldFont.setPointSizeF(fontSize);
-                    QApplication::setFont(oldFont);
+        if (key == "systemFont") {
+            // the family is looked up off the gui thread, a size change waits for it.
+            const QString font = settings->get("system-font").toString();
+            m_requested_font_family = font;
+            m_pending_font_lookups++;
+            auto watcher = new QFutureWatcher<bool>(this);
+            connect(watcher, &QFutureWatcher<bool>::finished, this, [=]() {
+                watcher->deleteLater();
+                m_pending_font_lookups--;
+                // an older lookup might finish after a newer one.
+                if (watcher->result() && font == m_requested_font_family) {
+                    m_font_family = font;
+                    m_font_family_changed = true;
                 }
-            }
-        });
+                if (m_pending_font_lookups == 0 && (m_font_family_changed || m_font_size_changed))
+                    scheduleSystemFont();
+            });
+            watcher->setFuture(FontFamilyIndex::globalInstance()->lookup(font));
+        }
+        if (key == "systemFontSize") {
+            m_font_size_changed = true;
+            if (m_pending_font_lookups == 0)
+                scheduleSystemFont();
+        }
+    };
+    connect(settings, &QGSettings::changed, this, onSettingsChanged);
+
+    if (bundle->isValid()) {
+        for (auto key : bundle->outdatedSettings())
+            onSettingsChanged(key);
+    } else {
+        // read from the settings, write them for the next applications.
+        ThemeBundle::generate(ukuiStandardPalette(false), ukuiStandardPalette(true));
     }
 }
 
 Qt5UKUIPlatformTheme::~Qt5UKUIPlatformTheme()
 {
+    delete m_palette;
+}
+
+/*!
+ * \brief Qt5UKUIPlatformTheme::updatePalette
+ * \details
+ * resolves the palette Qt5UKUIStyle polishes the application palette to, so
+ * that QGuiApplication is initialized with it and creating the style does
+ * not change the palette again. It follows the variant choice of
+ * Qt5UKUIStyle::standardPalette(). Applications not using a ukui style keep
+ * the palette of QPlatformTheme.
+ */
+void Qt5UKUIPlatformTheme::updatePalette()
+{
+    delete m_palette;
+    m_palette = nullptr;
+
+    if (blackAppList().contains(qAppName()))
+        return;
+
+    QString styleName;
+    auto bundle = ThemeBundle::globalInstance();
+    if (bundle->isValid())
+        styleName = bundle->setting("styleName").toString();
+    else if (UKUIStyleSettings::isSchemaInstalled("org.ukui.style"))
+        styleName = UKUIStyleSettings::globalInstance()->get("styleName").toString();
+
+    if (styleName == "ukui")
+        styleName = "ukui-default";
+    else if (styleName == "ukui-black")
+        styleName = "ukui-dark";
+    else if (styleName == "ukui-white")
+        styleName = "ukui-light";
+    if (styleName != "ukui-default" && styleName != "ukui-dark" && styleName != "ukui-light")
+        return;
+
+    const bool dark = !defaultPaletteAppList().contains(qAppName())
+            && (styleName == "ukui-dark" || (styleName == "ukui-default" && darkPaletteAppList().contains(qAppName())));
+
+    QVariant palette;
+    if (bundle->isValid())
+        palette = bundle->value(dark? THEME_BUNDLE_DARK_PALETTE: THEME_BUNDLE_LIGHT_PALETTE);
+    if (palette.canConvert<QPalette>()) {
+        m_palette = new QPalette(qvariant_cast<QPalette>(palette));
+    } else {
+        m_palette = new QPalette(ukuiStandardPalette(dark));
+    }
+}
+
+void Qt5UKUIPlatformTheme::scheduleSystemFont()
+{
+    ThemeChangeTransaction::schedule(ThemeChangeTransaction::Font, "systemFont", this, [=]() {
+        applySystemFont();
+    });
+}
+
+/*!
+ * \brief Qt5UKUIPlatformTheme::applySystemFont
+ * \details
+ * applies the changed family and size of the system font with one
+ * QApplication::setFont(), so that widgets are relayouted once.
+ */
+void Qt5UKUIPlatformTheme::applySystemFont()
+{
+    QFont font = QApplication::font();
+    if (m_font_family_changed) {
+        m_system_font.setFamily(m_font_family);
+        m_fixed_font.setFamily(m_font_family);
+        font.setFamily(m_font_family);
+    }
+    if (m_font_size_changed && !(qApp->property("noChangeSystemFontSize").isValid() && qApp->property("noChangeSystemFontSize").toBool())) {
+        double fontSize = UKUIStyleSettings::globalInstance()->get("system-font-size").toString().toDouble();
+        if (fontSize > 0) {
+            m_system_font.setPointSizeF(fontSize);
+            m_fixed_font.setPointSizeF(fontSize*1.2);
+            font.setPointSizeF(fontSize);
+        }
+    }
+    m_font_family_changed = false;
+    m_font_size_changed = false;
+
+    if (font != QApplication::font())
+        QApplication::setFont(font);
 }
 
 const QPalette *Qt5UKUIPlatformTheme::palette(Palette type) const
 {
-    //FIXME:
+    if (type == SystemPalette && m_palette)
+        return m_palette;
     return QPlatformTheme::palette(type);
 }
 
@@ -156,15 +315,20 @@ QVariant Qt5UKUIPlatformTheme::themeHint(ThemeHint hint) const
         return QStringList()<<"ukui";
 
     case QPlatformTheme::SystemIconThemeName: {
-        if (UKUIStyleSettings::isSchemaInstalled("org.ukui.style")) {
-            if (auto settings = UKUIStyleSettings::globalInstance()) {
-                QString icontheme = settings->get("icon-theme-name").toString();
-                if (icontheme == "ukui-icon-theme-default" || icontheme == "ukui")
-                    return QStringList()<<"ukui";
-                else if (icontheme == "ukui-icon-theme-classical" || icontheme == "ukui-classical")
-                    return QStringList()<<"ukui-classical";
-                return QStringList()<<icontheme;
-            }
+        QString icontheme;
+        auto bundle = ThemeBundle::globalInstance();
+        if (bundle->isValid()) {
+            icontheme = bundle->setting("iconThemeName").toString();
+        } else if (UKUIStyleSettings::isSchemaInstalled("org.ukui.style")) {
+            if (auto settings = UKUIStyleSettings::globalInstance())
+                icontheme = settings->get("icon-theme-name").toString();
+        }
+        if (!icontheme.isEmpty()) {
+            if (icontheme == "ukui-icon-theme-default" || icontheme == "ukui")
+                return QStringList()<<"ukui";
+            else if (icontheme == "ukui-icon-theme-classical" || icontheme == "ukui-classical")
+                return QStringList()<<"ukui-classical";
+            return QStringList()<<icontheme;
         }
         return "hicolor";
     }
@@ -237,8 +401,9 @@ QPlatformDialogHelper *Qt5UKUIPlatformTheme::createPlatformDialogHelper(DialogTy
 #if (QT_VERSION >= QT_VERSION_CHECK(5, 10, 0))
 QIcon Qt5UKUIPlatformTheme::fileIcon(const QFileInfo &fileInfo, QPlatformTheme::IconOptions iconOptions) const
 {
-    //FIXME:
-    return QPlatformTheme::fileIcon(fileInfo, iconOptions);
+    // we never use custom directory icons.
+    Q_UNUSED(iconOptions)
+    return FileIconProvider::globalInstance()->icon(fileInfo);
 }
 #endif
 
@@ -41,6 +41,8 @@
 #endif
 
 class QPalette;
+class QTimer;
+class IconThemeWarmer;
 #ifdef DBUS_TRAY
 class QPlatformSystemTrayIcon;
 #endif
@@ -87,8 +89,22 @@ public:
 #endif
 
 private:
+    void watchSettings();
+    void updatePalette();
+    void scheduleSystemFont();
+    void applySystemFont();
+
+    QPalette *m_palette = nullptr;
     QFont m_system_font;
     QFont m_fixed_font;
+    IconThemeWarmer *m_icon_theme_warmer = nullptr;
+    QTimer *m_bundle_timer = nullptr;
+
+    QString m_font_family;
+    QString m_requested_font_family;
+    int m_pending_font_lookups = 0;
+    bool m_font_family_changed = false;
+    bool m_font_size_changed = false;
 };
 
 #endif // QT5UKUIPLATFORMTHEME_H
@@ -4,7 +4,7 @@
 #
 #-------------------------------------------------
 
-QT       += widgets dbus gui-private widgets-private x11extras
+QT       += widgets dbus gui-private widgets-private x11extras concurrent
 
 greaterThan(QT_MAJOR_VERSION, 5)|greaterThan(QT_MINOR_VERSION, 7): \
     QT += theme_support-private
@@ -15,7 +15,7 @@ TARGET = qt5-ukui-platformtheme
 TEMPLATE = lib
 CONFIG += plugin
 CONFIG += c++11 link_pkgconfig
-PKGCONFIG += gsettings-qt Qt5XdgIconLoader
+PKGCONFIG += gsettings-qt Qt5XdgIconLoader fontconfig
 
 include(../libqt5-ukui-style/libqt5-ukui-style.pri)
 
@@ -40,10 +40,16 @@ include(widget/widget.pri)
 
 SOURCES += \
         qt5-ukui-platform-theme.cpp \
+    icon-theme-warmer.cpp \
+    font-family-index.cpp \
+    file-icon-provider.cpp \
     main.cpp
 
 HEADERS += \
         qt5-ukui-platform-theme.h \
+    icon-theme-warmer.h \
+    font-family-index.h \
+    file-icon-provider.h \
         qt5-ukui-platformtheme_global.h
 
 unix {
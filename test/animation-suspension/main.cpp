@@ -0,0 +1,182 @@
+/*
+ * Qt5-UKUI
+ *
+ * Copyright (C) 2020, Tianjin KYLIN Information Technology Co., Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * Authors: Yue Lan <lanyue@kylinos.cn>
+ *
+ */
+
+#include <QApplication>
+#include <QWidget>
+#include <QProgressBar>
+#include <QPushButton>
+#include <QScrollArea>
+#include <QScrollBar>
+#include <QTabWidget>
+#include <QLabel>
+#include <QVBoxLayout>
+#include <QEventLoop>
+#include <QTimer>
+#include <QDBusConnection>
+#include <QDBusInterface>
+#include <QDBusReply>
+#include <QPixmap>
+#include <QDebug>
+
+#include <functional>
+
+/// how long the animations are driven, and how long the window stays
+/// minimized or hidden.
+#define STAGE_DURATION 2000
+/// time for the window manager to minimize or map the window, and for the
+/// running animations to be snapped to their end.
+#define SETTLE_DURATION 300
+/// animations started by every toggle: the button, the scroll bar and the
+/// tab slide.
+#define ANIMATIONS_PER_TOGGLE 3
+/// ticks a suspended animation may take, the one that finds the window
+/// concealed and one more before it is snapped to its end. Running
+/// animations take 5 to 9 ticks.
+#define SUSPENDED_ANIMATION_TICKS 2
+
+static void wait(int ms)
+{
+    QEventLoop loop;
+    QTimer::singleShot(ms, &loop, &QEventLoop::quit);
+    loop.exec();
+}
+
+/// \return the style's animation counters, read from the paint statistics
+/// the style exports on our own session bus connection.
+static QPair<quint64, quint64> readTicks()
+{
+    QDBusInterface statistics(QDBusConnection::sessionBus().baseService(),
+                              "/org/ukui/style/PaintStatistics/style",
+                              "org.ukui.style.PaintStatistics");
+    QDBusReply<QString> reply = statistics.call("dump");
+    QPair<quint64, quint64> ticks(0, 0);
+    for (auto line : reply.value().split('\n')) {
+        auto fields = line.split(' ');
+        if (fields.count() != 2)
+            continue;
+        if (fields.first() == "AnimationTicks")
+            ticks.first = fields.last().toULongLong();
+        if (fields.first() == "ProgressClockTicks")
+            ticks.second = fields.last().toULongLong();
+    }
+    return ticks;
+}
+
+/// \return the ticks of animators and of the progress bar clock during \a ms.
+static QPair<quint64, quint64> countTicks(int ms)
+{
+    auto before = readTicks();
+    wait(ms);
+    auto after = readTicks();
+    return qMakePair(after.first - before.first, after.second - before.second);
+}
+
+/// count the ticks of the style's animators and of the busy progress bar
+/// clock while their window is visible, minimized and hidden.
+/// \details
+/// Run it in a ukui session. Hover animations of a button and a scroll bar
+/// and the slide of a tab widget are started repeatedly, next to a busy
+/// progress bar. Then the window is minimized, or hidden, and the animations
+/// are started again while it is concealed, by rendering the hovered
+/// controls into a pixmap. They should be snapped to their end on their
+/// first ticks, and the busy bar should not tick at all. After the window is
+/// shown again the busy bar should tick again.
+/// The exit code is the number of failed checks.
+int main(int argc, char *argv[])
+{
+    QApplication a(argc, argv);
+
+    QWidget w;
+    auto layout = new QVBoxLayout(&w);
+
+    auto progressBar = new QProgressBar(&w);
+    progressBar->setRange(0, 0);
+    layout->addWidget(progressBar);
+
+    auto button = new QPushButton("hover me", &w);
+    layout->addWidget(button);
+
+    auto scrollArea = new QScrollArea(&w);
+    auto content = new QWidget(scrollArea);
+    content->setFixedSize(1000, 1000);
+    scrollArea->setWidget(content);
+    auto scrollBar = scrollArea->verticalScrollBar();
+    layout->addWidget(scrollArea);
+
+    auto tabWidget = new QTabWidget(&w);
+    tabWidget->addTab(new QLabel("page 1"), "tab 1");
+    tabWidget->addTab(new QLabel("page 2"), "tab 2");
+    layout->addWidget(tabWidget);
+
+    // the style starts hover animations when it paints a hovered control,
+    // rendering paints it also when the window is concealed.
+    int toggles = 0;
+    auto toggleAnimations = [&]() {
+        for (QWidget *widget : {(QWidget *)button, (QWidget *)scrollBar}) {
+            widget->setAttribute(Qt::WA_UnderMouse, !widget->testAttribute(Qt::WA_UnderMouse));
+            QPixmap buffer(widget->size());
+            widget->render(&buffer);
+            widget->update();
+        }
+        tabWidget->setCurrentIndex(1 - tabWidget->currentIndex());
+        toggles++;
+    };
+    QTimer driver;
+    driver.setInterval(200);
+    QObject::connect(&driver, &QTimer::timeout, toggleAnimations);
+
+    w.show();
+    wait(1000);
+
+    int failures = 0;
+    auto checkStage = [&](const QString &name, const std::function<void()> &conceal, const std::function<void()> &reveal) {
+        driver.start();
+        auto ticks = countTicks(STAGE_DURATION);
+        qDebug()<<"animation and progress clock ticks while visible:"<<ticks.first<<ticks.second;
+        driver.stop();
+
+        conceal();
+        wait(SETTLE_DURATION);
+        const int visibleToggles = toggles;
+        driver.start();
+        ticks = countTicks(STAGE_DURATION);
+        driver.stop();
+        const quint64 started = quint64(toggles - visibleToggles) * ANIMATIONS_PER_TOGGLE;
+        qDebug()<<"animations started, animation and progress clock ticks while"<<name<<":"
+                <<started<<ticks.first<<ticks.second;
+        if (ticks.first > started * SUSPENDED_ANIMATION_TICKS || ticks.second > 0)
+            failures++;
+
+        reveal();
+        wait(SETTLE_DURATION);
+        ticks = countTicks(STAGE_DURATION);
+        qDebug()<<"progress clock ticks after"<<name<<":"<<ticks.second;
+        if (ticks.second == 0)
+            failures++;
+    };
+
+    checkStage("minimized", [&]() {w.showMinimized();}, [&]() {w.showNormal(); w.activateWindow();});
+    checkStage("hidden", [&]() {w.hide();}, [&]() {w.show();});
+
+    qDebug()<<"failed checks:"<<failures;
+    return failures;
+}
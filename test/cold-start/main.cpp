@@ -0,0 +1,97 @@
+/*
+ * Qt5-UKUI
+ *
+ * Copyright (C) 2020, Tianjin KYLIN Information Technology Co., Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * Authors: Yue Lan <lanyue@kylinos.cn>
+ *
+ */
+
+#include <QApplication>
+#include <QWidget>
+#include <QProcess>
+#include <QProcessEnvironment>
+#include <QElapsedTimer>
+#include <QTimer>
+#include <QDebug>
+
+#include <algorithm>
+
+#define RUNS 10
+
+/// the measured application: a plain widget, which quits once it is painted.
+class FirstPaintWidget : public QWidget
+{
+public:
+    explicit FirstPaintWidget(QWidget *parent = nullptr) : QWidget(parent) {}
+
+protected:
+    void paintEvent(QPaintEvent *e) override {
+        QWidget::paintEvent(e);
+        QTimer::singleShot(0, qApp, &QApplication::quit);
+    }
+};
+
+static int runChild(int argc, char *argv[])
+{
+    QApplication a(argc, argv);
+    FirstPaintWidget w;
+    w.show();
+    return a.exec();
+}
+
+/// \return the median time in ms from starting the child to its exit.
+static double measure(const QString &program, bool useThemeBundle)
+{
+    auto env = QProcessEnvironment::systemEnvironment();
+    if (useThemeBundle)
+        env.remove("QT5UKUI_NO_THEME_BUNDLE");
+    else
+        env.insert("QT5UKUI_NO_THEME_BUNDLE", "1");
+
+    QList<double> times;
+    for (int i = 0; i < RUNS; i++) {
+        QProcess child;
+        child.setProcessEnvironment(env);
+        QElapsedTimer timer;
+        timer.start();
+        child.start(program, QStringList()<<"--child");
+        child.waitForFinished(-1);
+        times<<timer.nsecsElapsed() / 1000000.0;
+    }
+    std::sort(times.begin(), times.end());
+    return times.at(RUNS / 2);
+}
+
+/// measure the cold start of a minimal QWidget application, to first paint,
+/// with and without the theme bundle.
+/// \details
+/// Run it in a ukui session. The first run with the bundle enabled writes
+/// the bundle if it is missing or stale, it is not measured.
+int main(int argc, char *argv[])
+{
+    if (argc > 1 && qstrcmp(argv[1], "--child") == 0)
+        return runChild(argc, argv);
+
+    QCoreApplication a(argc, argv);
+    const QString program = QCoreApplication::applicationFilePath();
+
+    QProcess::execute(program, QStringList()<<"--child");
+
+    qDebug()<<"median cold start without theme bundle:"<<measure(program, false)<<"ms";
+    qDebug()<<"median cold start with theme bundle:"<<measure(program, true)<<"ms";
+    return 0;
+}
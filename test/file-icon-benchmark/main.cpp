@@ -0,0 +1,84 @@
+/*
+ * Qt5-UKUI
+ *
+ * Copyright (C) 2020, Tianjin KYLIN Information Technology Co., Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * Authors: Yue Lan <lanyue@kylinos.cn>
+ *
+ */
+
+#include <QApplication>
+#include <QFileIconProvider>
+#include <QTemporaryDir>
+#include <QDir>
+#include <QFile>
+#include <QMimeDatabase>
+#include <QElapsedTimer>
+#include <QSet>
+#include <QDebug>
+
+#define FILE_COUNT 50000
+
+static void createFiles(const QString &path)
+{
+    // an empty suffix makes files that need content sniffing.
+    const QStringList suffixes = QStringList()<<"txt"<<"png"<<"pdf"<<"cpp"<<"h"<<"tar.gz"<<"odt"<<"mp3"<<"html"<<"";
+    for (int i = 0; i < FILE_COUNT; i++) {
+        const QString suffix = suffixes.at(i % suffixes.count());
+        QFile file(QString("%1/file%2%3").arg(path).arg(i).arg(suffix.isEmpty()? QString(): "." + suffix));
+        file.open(QIODevice::WriteOnly);
+        if (suffix.isEmpty())
+            file.write("#!/bin/sh\n");
+    }
+}
+
+/// time QFileIconProvider::icon() over a directory of FILE_COUNT files, the
+/// way a file dialog lists it.
+/// \details
+/// Run it with the ukui platform theme (QT_QPA_PLATFORMTHEME=ukui). The
+/// uncached pass resolves every file with QMimeDatabase and the icon theme,
+/// for comparison.
+int main(int argc, char *argv[])
+{
+    QApplication a(argc, argv);
+
+    QTemporaryDir dir;
+    if (!dir.isValid())
+        return 1;
+    createFiles(dir.path());
+    const QFileInfoList files = QDir(dir.path()).entryInfoList(QDir::Files | QDir::NoDotAndDotDot);
+
+    QElapsedTimer timer;
+    timer.start();
+    QMimeDatabase mimeDatabase;
+    for (auto info : files) {
+        const QMimeType type = mimeDatabase.mimeTypeForFile(info);
+        QIcon::fromTheme(type.iconName(), QIcon::fromTheme(type.genericIconName()));
+    }
+    qDebug()<<"uncached:"<<timer.elapsed()<<"ms for"<<files.count()<<"files";
+
+    QFileIconProvider provider;
+    for (int pass = 0; pass < 2; pass++) {
+        QSet<qint64> icons;
+        timer.restart();
+        for (auto info : files)
+            icons<<provider.icon(info).cacheKey();
+        qDebug()<<(pass == 0? "fileIcon() first listing:": "fileIcon() second listing:")<<timer.elapsed()<<"ms,"
+                <<icons.count()<<"distinct icons";
+    }
+
+    return 0;
+}
@@ -0,0 +1,134 @@
+/*
+ * Qt5-UKUI
+ *
+ * Copyright (C) 2020, Tianjin KYLIN Information Technology Co., Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * Authors: Yue Lan <lanyue@kylinos.cn>
+ *
+ */
+
+#include <QApplication>
+#include <QWidget>
+#include <QMenu>
+#include <QComboBox>
+#include <QVBoxLayout>
+#include <QElapsedTimer>
+#include <QTimer>
+#include <QWindow>
+#include <QDebug>
+
+#include <KWindowSystem>
+
+/// measure how long it takes from popping up a new menu until its first
+/// frame is painted and flushed to its native window.
+/// \details
+/// The style creates popups as rgb windows when there is no compositor,
+/// run this with and without a compositor to compare the cost of argb
+/// popup surfaces. Each menu is a new instance, so the native window and
+/// its backing store are created every time.
+///
+/// Qt paints and flushes a window in the handling of its Expose event, or of
+/// an UpdateRequest of the top-level widget. Those events are handled by the
+/// filter itself, so that the time is taken after the flush returned.
+class PopupLatencyTest : public QWidget
+{
+public:
+    explicit PopupLatencyTest(QWidget *parent = nullptr) : QWidget(parent) {
+        auto layout = new QVBoxLayout(this);
+        auto comboBox = new QComboBox(this);
+        comboBox->addItems(QStringList()<<"item1"<<"item2"<<"item3");
+        layout->addWidget(comboBox);
+    }
+
+    void popupNext() {
+        if (m_count == 20) {
+            qDebug()<<"compositing:"<<KWindowSystem::compositingActive()
+                    <<"average popup latency:"<<m_total / m_count / 1000<<"us";
+            qApp->quit();
+            return;
+        }
+
+        auto menu = new QMenu(this);
+        for (int i = 0; i < 10; i++) {
+            menu->addAction(QString("action%1").arg(i));
+        }
+        m_menu = menu;
+        m_painted = false;
+        menu->installEventFilter(this);
+        m_timer.start();
+        menu->popup(mapToGlobal(rect().center()));
+        // the native window is created by popup(), it is exposed later.
+        menu->windowHandle()->installEventFilter(this);
+    }
+
+    bool eventFilter(QObject *obj, QEvent *e) override {
+        if (!m_menu)
+            return false;
+
+        switch (e->type()) {
+        case QEvent::Paint:
+            if (obj == m_menu)
+                m_painted = true;
+            return false;
+        case QEvent::Expose:
+        case QEvent::UpdateRequest:
+            break;
+        default:
+            return false;
+        }
+
+        obj->event(e);
+        if (m_painted)
+            finishPopup();
+        return true;
+    }
+
+private:
+    void finishPopup() {
+        m_total += m_timer.nsecsElapsed();
+        m_count++;
+        auto menu = m_menu;
+        m_menu = nullptr;
+        menu->removeEventFilter(this);
+        menu->windowHandle()->removeEventFilter(this);
+        QTimer::singleShot(50, menu, [=]() {
+            menu->hide();
+            menu->deleteLater();
+            popupNext();
+        });
+    }
+
+    QMenu *m_menu = nullptr;
+    bool m_painted = false;
+private:
+    QElapsedTimer m_timer;
+    qint64 m_total = 0;
+    int m_count = 0;
+};
+
+int main(int argc, char *argv[])
+{
+    QApplication a(argc, argv);
+    PopupLatencyTest w;
+    w.resize(300, 200);
+    w.show();
+
+    QTimer::singleShot(1000, &w, [&]() {
+        w.popupNext();
+    });
+
+    return a.exec();
+}
@@ -0,0 +1,90 @@
+/*
+ * Qt5-UKUI
+ *
+ * Copyright (C) 2020, Tianjin KYLIN Information Technology Co., Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * Authors: Yue Lan <lanyue@kylinos.cn>
+ *
+ */
+
+#include <QApplication>
+#include <QWidget>
+#include <QGridLayout>
+#include <QPushButton>
+#include <QLineEdit>
+#include <QLabel>
+#include <QPalette>
+#include <QStyle>
+#include <QTimer>
+#include <QDebug>
+
+#define ROWS 50
+
+/// counts the palette change events delivered to any object.
+class PaletteEventCounter : public QObject
+{
+public:
+    explicit PaletteEventCounter(QObject *parent = nullptr) : QObject(parent) {}
+
+    int applicationPaletteChanges = 0;
+    int paletteChanges = 0;
+
+protected:
+    bool eventFilter(QObject *obj, QEvent *e) override {
+        if (e->type() == QEvent::ApplicationPaletteChange)
+            applicationPaletteChanges++;
+        if (e->type() == QEvent::PaletteChange)
+            paletteChanges++;
+        return QObject::eventFilter(obj, e);
+    }
+};
+
+/// start a window of a few hundred widgets, and count the palette change
+/// events from the construction of QApplication until a second after the
+/// window is shown.
+/// \details
+/// Run it in a ukui session. With the platform theme publishing the palette
+/// of the style, the palette QGuiApplication starts with is the final one
+/// and no palette change event is sent during the startup.
+int main(int argc, char *argv[])
+{
+    QApplication a(argc, argv);
+
+    // QGuiApplication::palette() does not create the style.
+    const QPalette initialPalette = QGuiApplication::palette();
+
+    PaletteEventCounter counter;
+    a.installEventFilter(&counter);
+
+    QWidget w;
+    auto layout = new QGridLayout(&w);
+    for (int i = 0; i < ROWS; i++) {
+        layout->addWidget(new QLabel(QString("label %1").arg(i), &w), i, 0);
+        layout->addWidget(new QLineEdit(&w), i, 1);
+        layout->addWidget(new QPushButton("button", &w), i, 2);
+    }
+    w.show();
+
+    QTimer::singleShot(1000, &a, [&]() {
+        qDebug()<<"style:"<<a.style()->metaObject()->className();
+        qDebug()<<"initial palette is the final one:"<<(initialPalette == QApplication::palette());
+        qDebug()<<"ApplicationPaletteChange events:"<<counter.applicationPaletteChanges;
+        qDebug()<<"PaletteChange events:"<<counter.paletteChanges;
+        a.quit();
+    });
+
+    return a.exec();
+}
@@ -0,0 +1,379 @@
+/*
+ * Qt5-UKUI
+ *
+ * Copyright (C) 2020, Tianjin KYLIN Information Technology Co., Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * Authors: Yue Lan <lanyue@kylinos.cn>
+ *
+ */
+
+#include <QtTest>
+#include <QApplication>
+#include <QStyleFactory>
+#include <QWidget>
+#include <QGridLayout>
+#include <QLabel>
+#include <QLineEdit>
+#include <QComboBox>
+#include <QSpinBox>
+#include <QPushButton>
+#include <QToolButton>
+#include <QTabBar>
+#include <QImage>
+#include <QPainter>
+#include <QListView>
+#include <QScrollBar>
+#include <QStringListModel>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QTextStream>
+
+#include "style-elements.h"
+
+#define FORM_ROWS 30
+#define MODEL_ROWS 100000
+#define SCROLL_STEPS 200
+#define REGRESSION_TOLERANCE 20
+#define ELEMENT_BATCH 50
+#define ELEMENT_MIN_TIME 20
+
+/// render benchmarks of the ukui style.
+/// \details
+/// The style is loaded as a plugin, so switches the style reads from
+/// qApp properties are used to compare the cached and the direct paths.
+///
+/// elements() times every element the style paints into an image with a
+/// painter made beforehand, the time per painting is reported to QtTest and
+/// written as csv to $STYLE_BENCHMARK_OUTPUT, and compared with the csv given by
+/// $STYLE_BENCHMARK_BASELINE. An element slower than the baseline by more
+/// than $STYLE_BENCHMARK_TOLERANCE percent (REGRESSION_TOLERANCE by default)
+/// fails the test.
+class StyleBenchmark : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+    void initTestCase();
+    void cleanupTestCase();
+
+    void renderForm_data();
+    void renderForm();
+
+    void scrollItemView_data();
+    void scrollItemView();
+
+    void elements_data();
+    void elements();
+
+private:
+    QWidget *createForm();
+    void writeElementResults();
+    void compareElementResults();
+
+    QWidget *m_form = nullptr;
+    QListView *m_view = nullptr;
+
+    QStyle *m_light_style = nullptr;
+    QStyle *m_dark_style = nullptr;
+    QList<StyleElement> m_elements;
+    /// ns per painting of each elements() row.
+    QMap<QString, double> m_element_results;
+};
+
+void StyleBenchmark::initTestCase()
+{
+    QStyle *style = QStyleFactory::create("ukui-default");
+    if (!style)
+        QSKIP("ukui-default style is not installed");
+    qApp->setStyle(style);
+
+    m_form = createForm();
+    m_form->resize(m_form->sizeHint());
+    // polish and lay out once, so that only painting is measured.
+    m_form->ensurePolished();
+    m_form->layout()->activate();
+
+    QStringList rows;
+    rows.reserve(MODEL_ROWS);
+    for (int i = 0; i < MODEL_ROWS; i++)
+        rows << QString("Row %1 of the model, with a description long enough to be elided %2").arg(i).arg(QString(i % 7, 'x'));
+    m_view = new QListView;
+    m_view->setModel(new QStringListModel(rows, m_view));
+    m_view->setUniformItemSizes(true);
+    m_view->setTextElideMode(Qt::ElideMiddle);
+    m_view->setVerticalScrollMode(QAbstractItemView::ScrollPerItem);
+    m_view->resize(320, 480);
+    m_view->ensurePolished();
+    // the view lays out its items lazily, do it now to get the scroll range.
+    m_view->doItemsLayout();
+
+    m_light_style = QStyleFactory::create("ukui-light");
+    m_dark_style = QStyleFactory::create("ukui-dark");
+    m_elements = styleElements();
+}
+
+void StyleBenchmark::cleanupTestCase()
+{
+    delete m_form;
+    delete m_view;
+    delete m_light_style;
+    delete m_dark_style;
+    qApp->setProperty("disableStyleSpriteCache", QVariant());
+    qApp->setProperty("disableStyleTextCache", QVariant());
+    qApp->setProperty("preferDark", QVariant());
+
+    if (!m_element_results.isEmpty()) {
+        writeElementResults();
+        compareElementResults();
+    }
+}
+
+void StyleBenchmark::renderForm_data()
+{
+    QTest::addColumn<bool>("spriteCache");
+    QTest::addColumn<qreal>("ratio");
+
+    QTest::newRow("sprite cache, dpr 1") << true << qreal(1);
+    QTest::newRow("direct, dpr 1") << false << qreal(1);
+    QTest::newRow("sprite cache, dpr 2") << true << qreal(2);
+    QTest::newRow("direct, dpr 2") << false << qreal(2);
+}
+
+/// paint a form heavy dialog, FORM_ROWS rows of line edits, combo boxes,
+/// spin boxes and buttons, with a tab bar on top.
+void StyleBenchmark::renderForm()
+{
+    QFETCH(bool, spriteCache);
+    QFETCH(qreal, ratio);
+
+    qApp->setProperty("disableStyleSpriteCache", !spriteCache);
+
+    QImage image(m_form->size() * ratio, QImage::Format_ARGB32_Premultiplied);
+    image.setDevicePixelRatio(ratio);
+
+    QBENCHMARK {
+        image.fill(Qt::transparent);
+        QPainter painter(&image);
+        m_form->render(&painter);
+    }
+}
+
+void StyleBenchmark::scrollItemView_data()
+{
+    QTest::addColumn<bool>("textCache");
+
+    QTest::newRow("text cache") << true;
+    QTest::newRow("direct") << false;
+}
+
+/// paint a list view of MODEL_ROWS elided rows, scrolled one row per frame,
+/// so that most rows of a frame were painted by the previous one.
+void StyleBenchmark::scrollItemView()
+{
+    QFETCH(bool, textCache);
+
+    qApp->setProperty("disableStyleTextCache", !textCache);
+
+    QImage image(m_view->size(), QImage::Format_ARGB32_Premultiplied);
+    QScrollBar *scrollBar = m_view->verticalScrollBar();
+    const int start = MODEL_ROWS / 2;
+
+    QBENCHMARK {
+        for (int i = 0; i < SCROLL_STEPS; i++) {
+            scrollBar->setValue(start + i);
+            image.fill(Qt::transparent);
+            QPainter painter(&image);
+            m_view->render(&painter);
+        }
+    }
+}
+
+void StyleBenchmark::elements_data()
+{
+    QTest::addColumn<int>("index");
+    QTest::addColumn<bool>("dark");
+    QTest::addColumn<int>("state");
+    QTest::addColumn<qreal>("ratio");
+
+    const QList<QPair<const char *, QStyle::State>> states = {
+        {"enabled", QStyle::State_Enabled},
+        {"disabled", QStyle::State_None},
+        {"hover", QStyle::State_Enabled | QStyle::State_MouseOver},
+        {"sunken", QStyle::State_Enabled | QStyle::State_Sunken},
+        {"checked", QStyle::State_Enabled | QStyle::State_On},
+        {"focus", QStyle::State_Enabled | QStyle::State_HasFocus},
+    };
+
+    for (int i = 0; i < m_elements.count(); i++) {
+        for (bool dark : {false, true}) {
+            for (auto state : states) {
+                for (qreal ratio : {qreal(1), qreal(2)}) {
+                    QString name = QString("%1/%2/%3/dpr %4").arg(m_elements.at(i).name)
+                            .arg(dark? "dark": "light").arg(state.first).arg(ratio);
+                    QTest::newRow(name.toUtf8().constData()) << i << dark << int(state.second) << ratio;
+                }
+            }
+        }
+    }
+}
+
+/// paint one element of the style in one state, with the option type and
+/// the host widget the element is painted for in applications.
+void StyleBenchmark::elements()
+{
+    QFETCH(int, index);
+    QFETCH(bool, dark);
+    QFETCH(int, state);
+    QFETCH(qreal, ratio);
+
+    QStyle *style = dark? m_dark_style: m_light_style;
+    if (!style)
+        QSKIP("ukui-light or ukui-dark style is not installed");
+    qApp->setProperty("preferDark", dark);
+
+    const StyleElement &element = m_elements.at(index);
+    QScopedPointer<QWidget> host(createHostWidget(element));
+    host->setStyle(style);
+    host->resize(element.size);
+    auto option = createStyleOption(element, host.data(), QStyle::State(state), style->standardPalette());
+
+    QImage image(element.size * ratio, QImage::Format_ARGB32_Premultiplied);
+    image.setDevicePixelRatio(ratio);
+    image.fill(Qt::transparent);
+    QPainter painter(&image);
+    // the first painting fills the style's caches, as in applications.
+    drawStyleElement(style, element, option.data(), &painter, host.data());
+
+    // only the paintings are timed, in batches until ELEMENT_MIN_TIME ms passed.
+    qint64 iterations = 0;
+    QElapsedTimer timer;
+    timer.start();
+    do {
+        for (int i = 0; i < ELEMENT_BATCH; i++)
+            drawStyleElement(style, element, option.data(), &painter, host.data());
+        iterations += ELEMENT_BATCH;
+    } while (timer.elapsed() < ELEMENT_MIN_TIME);
+    const double nsecs = double(timer.nsecsElapsed()) / iterations;
+
+    // QtTest reports the same time, in its own output formats too.
+    QTest::setBenchmarkResult(nsecs / 1000000, QTest::WalltimeMilliseconds);
+    m_element_results.insert(QTest::currentDataTag(), nsecs);
+}
+
+void StyleBenchmark::writeElementResults()
+{
+    const QString path = qEnvironmentVariable("STYLE_BENCHMARK_OUTPUT");
+    if (path.isEmpty())
+        return;
+
+    QFile file(path);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate | QIODevice::Text)) {
+        qWarning() << "can not write" << path;
+        return;
+    }
+    QTextStream out(&file);
+    out << "element,ns\n";
+    for (auto it = m_element_results.constBegin(); it != m_element_results.constEnd(); ++it)
+        out << it.key() << "," << qRound64(it.value()) << "\n";
+}
+
+void StyleBenchmark::compareElementResults()
+{
+    const QString path = qEnvironmentVariable("STYLE_BENCHMARK_BASELINE");
+    if (path.isEmpty())
+        return;
+
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly | QIODevice::Text)) {
+        qWarning() << "can not read" << path;
+        return;
+    }
+
+    bool ok = false;
+    int tolerance = qEnvironmentVariableIntValue("STYLE_BENCHMARK_TOLERANCE", &ok);
+    if (!ok)
+        tolerance = REGRESSION_TOLERANCE;
+
+    QStringList regressions;
+    QTextStream in(&file);
+    // skip the header line.
+    in.readLine();
+    while (!in.atEnd()) {
+        const QString line = in.readLine();
+        const int comma = line.lastIndexOf(',');
+        if (comma < 0)
+            continue;
+        const QString key = line.left(comma);
+        const double baseline = line.mid(comma + 1).toDouble();
+        if (baseline <= 0 || !m_element_results.contains(key))
+            continue;
+
+        const double current = m_element_results.value(key);
+        if (current > baseline * (100 + tolerance) / 100) {
+            qWarning().noquote() << QString("%1: %2 ns, baseline %3 ns").arg(key).arg(qRound64(current)).arg(qRound64(baseline));
+            regressions << key;
+        }
+    }
+
+    QVERIFY2(regressions.isEmpty(), qPrintable(QString("%1 elements are more than %2% slower than the baseline")
+                                               .arg(regressions.count()).arg(tolerance)));
+}
+
+QWidget *StyleBenchmark::createForm()
+{
+    auto form = new QWidget;
+    auto layout = new QGridLayout(form);
+
+    auto tabBar = new QTabBar(form);
+    for (int i = 0; i < 4; i++)
+        tabBar->addTab(QString("Page %1").arg(i));
+    layout->addWidget(tabBar, 0, 0, 1, 7);
+
+    for (int row = 1; row <= FORM_ROWS; row++) {
+        layout->addWidget(new QLabel(QString("Field %1").arg(row), form), row, 0);
+        auto lineEdit = new QLineEdit(form);
+        lineEdit->setPlaceholderText("text");
+        layout->addWidget(lineEdit, row, 1);
+        auto comboBox = new QComboBox(form);
+        comboBox->addItems(QStringList() << "first" << "second" << "third");
+        layout->addWidget(comboBox, row, 2);
+        auto editableComboBox = new QComboBox(form);
+        editableComboBox->setEditable(true);
+        layout->addWidget(editableComboBox, row, 3);
+        layout->addWidget(new QSpinBox(form), row, 4);
+        auto button = new QPushButton("Apply", form);
+        button->setEnabled(row % 3 != 0);
+        layout->addWidget(button, row, 5);
+        auto toolButton = new QToolButton(form);
+        toolButton->setText("...");
+        toolButton->setAutoRaise(row % 2 == 0);
+        layout->addWidget(toolButton, row, 6);
+    }
+    return form;
+}
+
+int main(int argc, char *argv[])
+{
+    // the benchmark does not need a display.
+    if (qEnvironmentVariableIsEmpty("QT_QPA_PLATFORM"))
+        qputenv("QT_QPA_PLATFORM", "offscreen");
+
+    QApplication app(argc, argv);
+    StyleBenchmark benchmark;
+    return QTest::qExec(&benchmark, argc, argv);
+}
+
+#include "main.moc"
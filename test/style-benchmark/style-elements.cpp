@@ -0,0 +1,477 @@
+/*
+ * Qt5-UKUI
+ *
+ * Copyright (C) 2020, Tianjin KYLIN Information Technology Co., Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * Authors: Yue Lan <lanyue@kylinos.cn>
+ *
+ */
+
+#include "style-elements.h"
+
+#include <QStyleOption>
+#include <QPainter>
+#include <QWidget>
+#include <QPushButton>
+#include <QToolButton>
+#include <QCheckBox>
+#include <QRadioButton>
+#include <QComboBox>
+#include <QSpinBox>
+#include <QSlider>
+#include <QScrollBar>
+#include <QDial>
+#include <QProgressBar>
+#include <QTabBar>
+#include <QTabWidget>
+#include <QHeaderView>
+#include <QMenu>
+#include <QMenuBar>
+#include <QLineEdit>
+#include <QGroupBox>
+#include <QToolBox>
+#include <QTreeView>
+#include <QLabel>
+#include <QStatusBar>
+#include <QSizeGrip>
+
+#define PRIMITIVE(e, w, h) {StyleElement::Primitive, QStyle::e, #e, QSize(w, h)}
+#define CONTROL(e, w, h) {StyleElement::Control, QStyle::e, #e, QSize(w, h)}
+#define COMPLEX_CONTROL(e, w, h) {StyleElement::ComplexControl, QStyle::e, #e, QSize(w, h)}
+
+/// the option classes used by the elements.
+enum OptionType {
+    GenericOption,
+    ButtonOption,
+    ToolButtonOption,
+    FrameOption,
+    TabWidgetFrameOption,
+    TabBarBaseOption,
+    FocusRectOption,
+    ViewItemOption,
+    HeaderOption,
+    TabOption,
+    ComboBoxOption,
+    MenuItemOption,
+    ProgressBarOption,
+    SliderOption,
+    ToolBoxOption,
+    SpinBoxOption,
+    GroupBoxOption,
+    SizeGripOption
+};
+
+QList<StyleElement> styleElements()
+{
+    return QList<StyleElement>()
+            << PRIMITIVE(PE_Frame, 160, 120)
+            << PRIMITIVE(PE_FrameFocusRect, 120, 32)
+            << PRIMITIVE(PE_FrameGroupBox, 160, 120)
+            << PRIMITIVE(PE_FrameMenu, 160, 240)
+            << PRIMITIVE(PE_FrameStatusBar, 320, 24)
+            << PRIMITIVE(PE_FrameTabBarBase, 320, 40)
+            << PRIMITIVE(PE_FrameTabWidget, 320, 240)
+            << PRIMITIVE(PE_IndicatorArrowDown, 16, 16)
+            << PRIMITIVE(PE_IndicatorArrowLeft, 16, 16)
+            << PRIMITIVE(PE_IndicatorArrowRight, 16, 16)
+            << PRIMITIVE(PE_IndicatorArrowUp, 16, 16)
+            << PRIMITIVE(PE_IndicatorBranch, 20, 32)
+            << PRIMITIVE(PE_IndicatorButtonDropDown, 24, 32)
+            << PRIMITIVE(PE_IndicatorCheckBox, 16, 16)
+            << PRIMITIVE(PE_IndicatorHeaderArrow, 16, 16)
+            << PRIMITIVE(PE_IndicatorRadioButton, 16, 16)
+            << PRIMITIVE(PE_IndicatorTabClose, 16, 16)
+            << PRIMITIVE(PE_IndicatorTabTearLeft, 16, 32)
+            << PRIMITIVE(PE_IndicatorTabTearRight, 16, 32)
+            << PRIMITIVE(PE_PanelButtonCommand, 120, 36)
+            << PRIMITIVE(PE_PanelButtonTool, 36, 36)
+            << PRIMITIVE(PE_PanelItemViewItem, 240, 36)
+            << PRIMITIVE(PE_PanelItemViewRow, 240, 36)
+            << PRIMITIVE(PE_PanelLineEdit, 160, 36)
+            << PRIMITIVE(PE_PanelMenu, 160, 240)
+            << PRIMITIVE(PE_PanelScrollAreaCorner, 16, 16)
+            << PRIMITIVE(PE_PanelTipLabel, 160, 36)
+
+            << CONTROL(CE_CheckBox, 120, 24)
+            << CONTROL(CE_CheckBoxLabel, 100, 24)
+            << CONTROL(CE_ComboBoxLabel, 160, 36)
+            << CONTROL(CE_Header, 120, 36)
+            << CONTROL(CE_HeaderEmptyArea, 120, 36)
+            << CONTROL(CE_HeaderLabel, 120, 36)
+            << CONTROL(CE_HeaderSection, 120, 36)
+            << CONTROL(CE_ItemViewItem, 240, 36)
+            << CONTROL(CE_MenuBarItem, 60, 28)
+            << CONTROL(CE_MenuItem, 160, 36)
+            << CONTROL(CE_ProgressBar, 240, 16)
+            << CONTROL(CE_ProgressBarContents, 240, 16)
+            << CONTROL(CE_ProgressBarGroove, 240, 16)
+            << CONTROL(CE_ProgressBarLabel, 240, 16)
+            << CONTROL(CE_PushButton, 120, 36)
+            << CONTROL(CE_PushButtonBevel, 120, 36)
+            << CONTROL(CE_PushButtonLabel, 120, 36)
+            << CONTROL(CE_RadioButton, 120, 24)
+            << CONTROL(CE_RadioButtonLabel, 100, 24)
+            << CONTROL(CE_ScrollBarAddLine, 16, 16)
+            << CONTROL(CE_ScrollBarSlider, 16, 120)
+            << CONTROL(CE_ScrollBarSubLine, 16, 16)
+            << CONTROL(CE_SizeGrip, 16, 16)
+            << CONTROL(CE_TabBarTab, 120, 40)
+            << CONTROL(CE_TabBarTabLabel, 120, 40)
+            << CONTROL(CE_TabBarTabShape, 120, 40)
+            << CONTROL(CE_ToolBoxTab, 240, 36)
+            << CONTROL(CE_ToolBoxTabLabel, 240, 36)
+            << CONTROL(CE_ToolBoxTabShape, 240, 36)
+            << CONTROL(CE_ToolButtonLabel, 36, 36)
+
+            << COMPLEX_CONTROL(CC_ComboBox, 160, 36)
+            << COMPLEX_CONTROL(CC_Dial, 64, 64)
+            << COMPLEX_CONTROL(CC_GroupBox, 160, 120)
+            << COMPLEX_CONTROL(CC_ScrollBar, 16, 240)
+            << COMPLEX_CONTROL(CC_Slider, 240, 24)
+            << COMPLEX_CONTROL(CC_SpinBox, 120, 36)
+            << COMPLEX_CONTROL(CC_ToolButton, 36, 36);
+}
+
+static OptionType optionType(const StyleElement &element)
+{
+    switch (element.kind) {
+    case StyleElement::Primitive:
+        switch (element.element) {
+        case QStyle::PE_IndicatorCheckBox:
+        case QStyle::PE_IndicatorRadioButton:
+        case QStyle::PE_PanelButtonCommand:
+            return ButtonOption;
+        case QStyle::PE_PanelButtonTool:
+            return ToolButtonOption;
+        case QStyle::PE_Frame:
+        case QStyle::PE_FrameGroupBox:
+        case QStyle::PE_FrameMenu:
+        case QStyle::PE_FrameStatusBar:
+        case QStyle::PE_PanelLineEdit:
+        case QStyle::PE_PanelMenu:
+        case QStyle::PE_PanelTipLabel:
+            return FrameOption;
+        case QStyle::PE_FrameTabWidget:
+            return TabWidgetFrameOption;
+        case QStyle::PE_FrameTabBarBase:
+            return TabBarBaseOption;
+        case QStyle::PE_FrameFocusRect:
+            return FocusRectOption;
+        case QStyle::PE_IndicatorBranch:
+        case QStyle::PE_PanelItemViewItem:
+        case QStyle::PE_PanelItemViewRow:
+            return ViewItemOption;
+        case QStyle::PE_IndicatorHeaderArrow:
+            return HeaderOption;
+        default:
+            return GenericOption;
+        }
+    case StyleElement::Control:
+        switch (element.element) {
+        case QStyle::CE_CheckBox:
+        case QStyle::CE_CheckBoxLabel:
+        case QStyle::CE_PushButton:
+        case QStyle::CE_PushButtonBevel:
+        case QStyle::CE_PushButtonLabel:
+        case QStyle::CE_RadioButton:
+        case QStyle::CE_RadioButtonLabel:
+            return ButtonOption;
+        case QStyle::CE_ComboBoxLabel:
+            return ComboBoxOption;
+        case QStyle::CE_Header:
+        case QStyle::CE_HeaderEmptyArea:
+        case QStyle::CE_HeaderLabel:
+        case QStyle::CE_HeaderSection:
+            return HeaderOption;
+        case QStyle::CE_ItemViewItem:
+            return ViewItemOption;
+        case QStyle::CE_MenuBarItem:
+        case QStyle::CE_MenuItem:
+            return MenuItemOption;
+        case QStyle::CE_ProgressBar:
+        case QStyle::CE_ProgressBarContents:
+        case QStyle::CE_ProgressBarGroove:
+        case QStyle::CE_ProgressBarLabel:
+            return ProgressBarOption;
+        case QStyle::CE_ScrollBarAddLine:
+        case QStyle::CE_ScrollBarSlider:
+        case QStyle::CE_ScrollBarSubLine:
+            return SliderOption;
+        case QStyle::CE_SizeGrip:
+            return SizeGripOption;
+        case QStyle::CE_TabBarTab:
+        case QStyle::CE_TabBarTabLabel:
+        case QStyle::CE_TabBarTabShape:
+            return TabOption;
+        case QStyle::CE_ToolBoxTab:
+        case QStyle::CE_ToolBoxTabLabel:
+        case QStyle::CE_ToolBoxTabShape:
+            return ToolBoxOption;
+        case QStyle::CE_ToolButtonLabel:
+            return ToolButtonOption;
+        default:
+            return GenericOption;
+        }
+    case StyleElement::ComplexControl:
+        switch (element.element) {
+        case QStyle::CC_ComboBox:
+            return ComboBoxOption;
+        case QStyle::CC_Dial:
+        case QStyle::CC_ScrollBar:
+        case QStyle::CC_Slider:
+            return SliderOption;
+        case QStyle::CC_GroupBox:
+            return GroupBoxOption;
+        case QStyle::CC_SpinBox:
+            return SpinBoxOption;
+        case QStyle::CC_ToolButton:
+            return ToolButtonOption;
+        default:
+            return GenericOption;
+        }
+    }
+    return GenericOption;
+}
+
+QWidget *createHostWidget(const StyleElement &element)
+{
+    switch (optionType(element)) {
+    case ButtonOption:
+        if (element.element == QStyle::PE_IndicatorCheckBox || element.element == QStyle::CE_CheckBox
+                || element.element == QStyle::CE_CheckBoxLabel)
+            return new QCheckBox("Check box");
+        if (element.element == QStyle::PE_IndicatorRadioButton || element.element == QStyle::CE_RadioButton
+                || element.element == QStyle::CE_RadioButtonLabel)
+            return new QRadioButton("Radio button");
+        return new QPushButton("Button");
+    case ToolButtonOption:
+        return new QToolButton;
+    case FrameOption:
+        switch (element.element) {
+        case QStyle::PE_FrameMenu:
+        case QStyle::PE_PanelMenu:
+            return new QMenu;
+        case QStyle::PE_PanelLineEdit:
+            return new QLineEdit;
+        case QStyle::PE_FrameGroupBox:
+            return new QGroupBox;
+        case QStyle::PE_FrameStatusBar:
+            return new QStatusBar;
+        case QStyle::PE_PanelTipLabel:
+            return new QLabel("Tool tip");
+        default:
+            return new QFrame;
+        }
+    case TabWidgetFrameOption:
+        return new QTabWidget;
+    case TabBarBaseOption:
+    case TabOption:
+        return new QTabBar;
+    case ViewItemOption:
+        return new QTreeView;
+    case HeaderOption:
+        return new QHeaderView(Qt::Horizontal);
+    case ComboBoxOption:
+        return new QComboBox;
+    case MenuItemOption:
+        if (element.element == QStyle::CE_MenuBarItem)
+            return new QMenuBar;
+        return new QMenu;
+    case ProgressBarOption:
+        return new QProgressBar;
+    case SliderOption:
+        if (element.element == QStyle::CC_Dial)
+            return new QDial;
+        if (element.element == QStyle::CC_Slider)
+            return new QSlider(Qt::Horizontal);
+        return new QScrollBar(Qt::Vertical);
+    case ToolBoxOption:
+        return new QToolBox;
+    case SpinBoxOption:
+        return new QSpinBox;
+    case GroupBoxOption:
+        return new QGroupBox("Group box");
+    case SizeGripOption:
+        return new QSizeGrip(nullptr);
+    default:
+        return new QWidget;
+    }
+}
+
+template <typename Option>
+static QSharedPointer<Option> initOption(const StyleElement &element, QWidget *host,
+                                         QStyle::State state, const QPalette &palette)
+{
+    QSharedPointer<Option> option(new Option);
+    option->initFrom(host);
+    option->rect = QRect(QPoint(0, 0), element.size);
+    option->state = state;
+    option->palette = palette;
+    return option;
+}
+
+QSharedPointer<QStyleOption> createStyleOption(const StyleElement &element, QWidget *host,
+                                               QStyle::State state, const QPalette &palette)
+{
+    switch (optionType(element)) {
+    case ButtonOption: {
+        auto option = initOption<QStyleOptionButton>(element, host, state, palette);
+        option->text = "Button";
+        return option;
+    }
+    case ToolButtonOption: {
+        auto option = initOption<QStyleOptionToolButton>(element, host, state, palette);
+        option->subControls = QStyle::SC_ToolButton;
+        option->activeSubControls = (state & QStyle::State_Sunken)? QStyle::SC_ToolButton: QStyle::SC_None;
+        option->toolButtonStyle = Qt::ToolButtonTextOnly;
+        option->text = "Tool";
+        return option;
+    }
+    case FrameOption: {
+        auto option = initOption<QStyleOptionFrame>(element, host, state, palette);
+        option->lineWidth = 1;
+        return option;
+    }
+    case TabWidgetFrameOption: {
+        auto option = initOption<QStyleOptionTabWidgetFrame>(element, host, state, palette);
+        option->tabBarSize = QSize(element.size.width(), 40);
+        return option;
+    }
+    case TabBarBaseOption: {
+        auto option = initOption<QStyleOptionTabBarBase>(element, host, state, palette);
+        option->tabBarRect = option->rect;
+        option->selectedTabRect = QRect(0, 0, 120, option->rect.height());
+        return option;
+    }
+    case FocusRectOption:
+        return initOption<QStyleOptionFocusRect>(element, host, state, palette);
+    case ViewItemOption: {
+        auto option = initOption<QStyleOptionViewItem>(element, host, state, palette);
+        option->text = "Item view item";
+        option->features = QStyleOptionViewItem::HasDisplay;
+        if (state & QStyle::State_On) {
+            option->features |= QStyleOptionViewItem::HasCheckIndicator;
+            option->checkState = Qt::Checked;
+        }
+        option->displayAlignment = Qt::AlignLeft | Qt::AlignVCenter;
+        option->viewItemPosition = QStyleOptionViewItem::OnlyOne;
+        option->state |= QStyle::State_Children;
+        option->widget = host;
+        return option;
+    }
+    case HeaderOption: {
+        auto option = initOption<QStyleOptionHeader>(element, host, state, palette);
+        option->text = "Header";
+        option->position = QStyleOptionHeader::Middle;
+        option->sortIndicator = QStyleOptionHeader::SortDown;
+        option->orientation = Qt::Horizontal;
+        return option;
+    }
+    case TabOption: {
+        auto option = initOption<QStyleOptionTab>(element, host, state, palette);
+        option->text = "Tab";
+        option->shape = QTabBar::RoundedNorth;
+        option->position = QStyleOptionTab::Middle;
+        if (state & QStyle::State_On)
+            option->state |= QStyle::State_Selected;
+        return option;
+    }
+    case ComboBoxOption: {
+        auto option = initOption<QStyleOptionComboBox>(element, host, state, palette);
+        option->currentText = "Combo box";
+        option->subControls = QStyle::SC_All;
+        option->frame = true;
+        return option;
+    }
+    case MenuItemOption: {
+        auto option = initOption<QStyleOptionMenuItem>(element, host, state, palette);
+        option->text = "Menu item\tCtrl+M";
+        option->menuItemType = QStyleOptionMenuItem::Normal;
+        option->checkType = QStyleOptionMenuItem::NonExclusive;
+        option->checked = state & QStyle::State_On;
+        option->menuRect = option->rect;
+        option->maxIconWidth = 16;
+        option->tabWidth = 40;
+        if (state & QStyle::State_MouseOver)
+            option->state |= QStyle::State_Selected;
+        return option;
+    }
+    case ProgressBarOption: {
+        auto option = initOption<QStyleOptionProgressBar>(element, host, state, palette);
+        option->minimum = 0;
+        option->maximum = 100;
+        option->progress = 40;
+        option->text = "40%";
+        option->textVisible = true;
+        option->orientation = Qt::Horizontal;
+        return option;
+    }
+    case SliderOption: {
+        auto option = initOption<QStyleOptionSlider>(element, host, state, palette);
+        option->orientation = element.size.width() > element.size.height()? Qt::Horizontal: Qt::Vertical;
+        option->minimum = 0;
+        option->maximum = 100;
+        option->sliderPosition = option->sliderValue = 40;
+        option->singleStep = 1;
+        option->pageStep = 10;
+        option->tickInterval = 10;
+        option->tickPosition = QSlider::TicksBelow;
+        option->subControls = QStyle::SC_All;
+        option->activeSubControls = (state & (QStyle::State_Sunken | QStyle::State_MouseOver))? QStyle::SC_SliderHandle: QStyle::SC_None;
+        return option;
+    }
+    case ToolBoxOption: {
+        auto option = initOption<QStyleOptionToolBox>(element, host, state, palette);
+        option->text = "Tool box page";
+        return option;
+    }
+    case SpinBoxOption: {
+        auto option = initOption<QStyleOptionSpinBox>(element, host, state, palette);
+        option->subControls = QStyle::SC_All;
+        option->stepEnabled = QAbstractSpinBox::StepUpEnabled | QAbstractSpinBox::StepDownEnabled;
+        option->frame = true;
+        return option;
+    }
+    case GroupBoxOption: {
+        auto option = initOption<QStyleOptionGroupBox>(element, host, state, palette);
+        option->text = "Group box";
+        option->subControls = QStyle::SC_GroupBoxFrame | QStyle::SC_GroupBoxLabel | QStyle::SC_GroupBoxCheckBox;
+        option->textAlignment = Qt::AlignLeft;
+        return option;
+    }
+    case SizeGripOption:
+        return initOption<QStyleOptionSizeGrip>(element, host, state, palette);
+    default:
+        return initOption<QStyleOption>(element, host, state, palette);
+    }
+}
+
+void drawStyleElement(const QStyle *style, const StyleElement &element, const QStyleOption *option,
+                      QPainter *painter, const QWidget *host)
+{
+    switch (element.kind) {
+    case StyleElement::Primitive:
+        style->drawPrimitive(QStyle::PrimitiveElement(element.element), option, painter, host);
+        break;
+    case StyleElement::Control:
+        style->drawControl(QStyle::ControlElement(element.element), option, painter, host);
+        break;
+    case StyleElement::ComplexControl:
+        style->drawComplexControl(QStyle::ComplexControl(element.element),
+                                  static_cast<const QStyleOptionComplex *>(option), painter, host);
+        break;
+    }
+}
@@ -0,0 +1,61 @@
+/*
+ * Qt5-UKUI
+ *
+ * Copyright (C) 2020, Tianjin KYLIN Information Technology Co., Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * Authors: Yue Lan <lanyue@kylinos.cn>
+ *
+ */
+
+#ifndef STYLEELEMENTS_H
+#define STYLEELEMENTS_H
+
+#include <QStyle>
+#include <QSharedPointer>
+#include <QList>
+
+class QPainter;
+
+/// one element the ukui style paints itself.
+struct StyleElement
+{
+    enum Kind {
+        Primitive,
+        Control,
+        ComplexControl
+    };
+
+    Kind kind;
+    int element;
+    const char *name;
+    QSize size;
+};
+
+/// every PE_*, CE_* and CC_* branch of Qt5UKUIStyle.
+QList<StyleElement> styleElements();
+
+/// a widget of the type the element is normally painted for, some branches
+/// read properties of the widget.
+QWidget *createHostWidget(const StyleElement &element);
+
+/// an option of the type the element expects, at (0, 0) with element's size.
+QSharedPointer<QStyleOption> createStyleOption(const StyleElement &element, QWidget *host,
+                                               QStyle::State state, const QPalette &palette);
+
+void drawStyleElement(const QStyle *style, const StyleElement &element, const QStyleOption *option,
+                      QPainter *painter, const QWidget *host);
+
+#endif // STYLEELEMENTS_H
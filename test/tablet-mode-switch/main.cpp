@@ -0,0 +1,122 @@
+/*
+ * Qt5-UKUI
+ *
+ * Copyright (C) 2020, Tianjin KYLIN Information Technology Co., Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * Authors: Yue Lan <lanyue@kylinos.cn>
+ *
+ */
+
+#include <QApplication>
+#include <QProxyStyle>
+#include <QScrollArea>
+#include <QGridLayout>
+#include <QPushButton>
+#include <QLabel>
+#include <QListWidget>
+#include <QElapsedTimer>
+#include <QTimer>
+#include <QDebug>
+
+#include <algorithm>
+
+#define COLUMNS 100
+#define ROWS 100
+#define TOGGLES 20
+
+/// counts the events a tablet mode switch sends to widgets.
+class StyleEventCounter : public QObject
+{
+public:
+    explicit StyleEventCounter(QObject *parent = nullptr) : QObject(parent) {}
+
+    int styleChanges = 0;
+    int applicationPaletteChanges = 0;
+
+protected:
+    bool eventFilter(QObject *obj, QEvent *e) override {
+        if (e->type() == QEvent::StyleChange)
+            styleChanges++;
+        if (e->type() == QEvent::ApplicationPaletteChange)
+            applicationPaletteChanges++;
+        return QObject::eventFilter(obj, e);
+    }
+};
+
+/// toggle the tablet mode of the ukui style in a window of 10k widgets, one
+/// item view in each row, and report the median latency of a toggle,
+/// including the relayout and repaint it causes, and the events sent.
+/// \details
+/// Run it in a ukui session. The toggle is invoked on the style like the
+/// status manager's mode_change_signal does.
+int main(int argc, char *argv[])
+{
+    QApplication a(argc, argv);
+
+    QStyle *style = a.style();
+    if (auto proxy = qobject_cast<QProxyStyle *>(style))
+        style = proxy->baseStyle();
+    if (!style->inherits("Qt5UKUIStyle")) {
+        qWarning()<<"the ukui style is not in use:"<<style->metaObject()->className();
+        return -1;
+    }
+
+    QScrollArea w;
+    auto content = new QWidget;
+    auto layout = new QGridLayout(content);
+    for (int row = 0; row < ROWS; row++) {
+        auto view = new QListWidget(content);
+        view->addItems(QStringList()<<"item 1"<<"item 2"<<"item 3");
+        // the viewport and scroll bars of a view are widgets too.
+        int count = view->findChildren<QWidget *>().count() + 1;
+        layout->addWidget(view, row, 0);
+        for (int column = 1; count < COLUMNS; column++, count++) {
+            if (column % 2)
+                layout->addWidget(new QLabel("label", content), row, column);
+            else
+                layout->addWidget(new QPushButton("button", content), row, column);
+        }
+    }
+    w.setWidget(content);
+    w.resize(800, 600);
+    w.show();
+
+    QTimer::singleShot(1000, &a, [&]() {
+        qDebug()<<"widgets:"<<QApplication::allWidgets().count();
+
+        StyleEventCounter counter;
+        a.installEventFilter(&counter);
+
+        QList<double> times;
+        bool tabletMode = style->styleHint(QStyle::SH_ItemView_ActivateItemOnSingleClick);
+        for (int i = 0; i < TOGGLES; i++) {
+            tabletMode = !tabletMode;
+            QElapsedTimer timer;
+            timer.start();
+            QMetaObject::invokeMethod(style, "updateTabletModeValue", Qt::DirectConnection, Q_ARG(bool, tabletMode));
+            QApplication::processEvents();
+            times<<timer.nsecsElapsed() / 1000000.0;
+        }
+        std::sort(times.begin(), times.end());
+
+        qDebug()<<"median toggle latency:"<<times.at(TOGGLES / 2)<<"ms";
+        qDebug()<<"StyleChange events per toggle:"<<counter.styleChanges / TOGGLES;
+        qDebug()<<"ApplicationPaletteChange events per toggle:"<<counter.applicationPaletteChanges / TOGGLES;
+        a.quit();
+    });
+
+    return a.exec();
+}
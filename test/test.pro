@@ -7,4 +7,12 @@ SUBDIRS += \
     region-blur \
     system-settings \
     tabwidget \
-    mps-style-application
+    mps-style-application \
+    animation-suspension \
+    popup-latency \
+    style-benchmark \
+    cold-start \
+    theme-switch-events \
+    file-icon-benchmark \
+    startup-palette-events \
+    tablet-mode-switch
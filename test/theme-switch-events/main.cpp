@@ -0,0 +1,170 @@
+/*
+ * Qt5-UKUI
+ *
+ * Copyright (C) 2020, Tianjin KYLIN Information Technology Co., Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * Authors: Yue Lan <lanyue@kylinos.cn>
+ *
+ */
+
+// before Qt, gio uses "signals" as a member name.
+#include <gio/gio.h>
+#include <glib-unix.h>
+#include <signal.h>
+
+#include <QApplication>
+#include <QWidget>
+#include <QPushButton>
+#include <QLabel>
+#include <QLineEdit>
+#include <QCheckBox>
+#include <QGridLayout>
+#include <QTimer>
+#include <QHash>
+#include <QDebug>
+
+#include <QGSettings>
+
+#define WIDGET_ROWS 50
+// time for all changes of a switch to arrive and be applied.
+#define SETTLE_TIME 2000
+
+/// count the events a theme switch causes in every widget.
+class EventCounter : public QObject
+{
+public:
+    bool eventFilter(QObject *obj, QEvent *e) override {
+        if (!obj->isWidgetType())
+            return false;
+
+        switch (e->type()) {
+        case QEvent::Polish:
+        case QEvent::PolishRequest:
+        case QEvent::StyleChange:
+        case QEvent::PaletteChange:
+        case QEvent::FontChange:
+        case QEvent::LayoutRequest:
+        case QEvent::Paint:
+            m_counts[e->type()]++;
+            break;
+        default:
+            break;
+        }
+        return false;
+    }
+
+    void report(const QString &title) {
+        qDebug()<<title<<"polish:"<<m_counts.value(QEvent::Polish)
+                <<"polish request:"<<m_counts.value(QEvent::PolishRequest)
+                <<"style:"<<m_counts.value(QEvent::StyleChange)
+                <<"palette:"<<m_counts.value(QEvent::PaletteChange)
+                <<"font:"<<m_counts.value(QEvent::FontChange)
+                <<"layout:"<<m_counts.value(QEvent::LayoutRequest)
+                <<"paint:"<<m_counts.value(QEvent::Paint);
+        m_counts.clear();
+    }
+
+private:
+    QHash<int, int> m_counts;
+};
+
+/// switch the theme the way the control center does, one key after another.
+static void switchTheme(QGSettings *settings, const QString &styleName, const QString &iconTheme, const QString &fontSize)
+{
+    settings->set("style-name", styleName);
+    settings->set("icon-theme-name", iconTheme);
+    settings->set("system-font-size", fontSize);
+}
+
+/// restore the user's theme however main() is left.
+class ThemeRestorer
+{
+public:
+    ThemeRestorer(QGSettings *settings, const QString &styleName, const QString &iconTheme, const QString &fontSize)
+        : m_settings(settings), m_style_name(styleName), m_icon_theme(iconTheme), m_font_size(fontSize) {}
+    ~ThemeRestorer() {
+        switchTheme(m_settings, m_style_name, m_icon_theme, m_font_size);
+        // the writes are asynchronous, finish them before the process exits.
+        g_settings_sync();
+    }
+
+private:
+    QGSettings *m_settings;
+    QString m_style_name;
+    QString m_icon_theme;
+    QString m_font_size;
+};
+
+/// count polish, layout and paint events per theme switch in a window of
+/// WIDGET_ROWS * 4 widgets.
+/// \details
+/// Run it in a ukui session, it switches the theme and restores it on exit,
+/// also when it is closed or interrupted early. Run it again with
+/// QT5UKUI_NO_THEME_TRANSACTION set to compare with the changes applied one
+/// by one.
+int main(int argc, char *argv[])
+{
+    QApplication a(argc, argv);
+
+    if (!QGSettings::isSchemaInstalled("org.ukui.style")) {
+        qWarning()<<"org.ukui.style is not installed";
+        return 1;
+    }
+
+    QWidget w;
+    auto layout = new QGridLayout(&w);
+    for (int i = 0; i < WIDGET_ROWS; i++) {
+        layout->addWidget(new QPushButton(QString("button%1").arg(i)), i, 0);
+        layout->addWidget(new QLabel(QString("label%1").arg(i)), i, 1);
+        layout->addWidget(new QLineEdit(QString("line edit%1").arg(i)), i, 2);
+        layout->addWidget(new QCheckBox(QString("check box%1").arg(i)), i, 3);
+    }
+    w.show();
+
+    auto settings = new QGSettings("org.ukui.style", QByteArray(), &a);
+    const QString styleName = settings->get("style-name").toString();
+    const QString iconTheme = settings->get("icon-theme-name").toString();
+    const QString fontSize = settings->get("system-font-size").toString();
+    ThemeRestorer restorer(settings, styleName, iconTheme, fontSize);
+
+    // quit on ctrl+c or kill too, the restorer runs when main() returns.
+    auto quit = [](gpointer) -> gboolean {
+        qApp->quit();
+        return G_SOURCE_CONTINUE;
+    };
+    g_unix_signal_add(SIGINT, quit, nullptr);
+    g_unix_signal_add(SIGTERM, quit, nullptr);
+
+    const QString otherStyleName = styleName == "ukui-dark"? "ukui-light": "ukui-dark";
+    const QString otherIconTheme = iconTheme == "ukui-classical"? "ukui": "ukui-classical";
+    const QString otherFontSize = QString::number(fontSize.toDouble() + 1);
+
+    EventCounter counter;
+    QTimer::singleShot(SETTLE_TIME, &a, [&]() {
+        a.installEventFilter(&counter);
+        switchTheme(settings, otherStyleName, otherIconTheme, otherFontSize);
+    });
+    QTimer::singleShot(SETTLE_TIME * 2, &a, [&]() {
+        counter.report("switch:");
+        switchTheme(settings, styleName, iconTheme, fontSize);
+    });
+    QTimer::singleShot(SETTLE_TIME * 3, &a, [&]() {
+        counter.report("restore:");
+        a.quit();
+    });
+
+    return a.exec();
+}
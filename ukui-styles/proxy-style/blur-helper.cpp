@@ -22,6 +22,9 @@
 
 #include "blur-helper.h"
 #include "ukui-style-settings.h"
+#include "rounded-rect-region.h"
+#include "paint-statistics.h"
+#include "theme-change-transaction.h"
 #include <QWidget>
 #include <KWindowEffects>
 #include <QGSettings>
@@ -39,18 +42,33 @@
 
 #include <QDebug>
 
+/// every blur region written to the window manager goes through here, so
+/// that the writes are counted by PaintStatistics.
+static void enableBlurBehind(WId window, bool enable, const QRegion &region = QRegion())
+{
+    PaintStatistics::count(PaintStatistics::BlurRegionWrites);
+    KWindowEffects::enableBlurBehind(window, enable, region);
+}
+
 BlurHelper::BlurHelper(QObject *parent) : QObject(parent)
 {
     if (QGSettings::isSchemaInstalled("org.ukui.style")) {
         auto settings = UKUIStyleSettings::globalInstance();
         connect(settings, &QGSettings::changed, this, [=](const QString &key) {
             if (key == "enabledGlobalBlur") {
-                bool enable = settings->get(key).toBool();
-                this->onBlurEnableChanged(enable);
+                ThemeChangeTransaction::schedule(ThemeChangeTransaction::WindowEffects, key, this, [=]() {
+                    m_global_blur_enable = settings->get(key).toBool();
+                    this->onBlurEnableChanged(m_global_blur_enable && !m_low_end_mode);
+                });
+            }
+            if (key == "lowEndMode") {
+                this->onLowEndModeChanged(settings->get(key).toBool());
             }
         });
-        bool enable = settings->get("enabledGlobalBlur").toBool();
-        this->onBlurEnableChanged(enable);
+        if (settings->keys().contains("lowEndMode"))
+            m_low_end_mode = settings->get("lowEndMode").toBool();
+        m_global_blur_enable = settings->get("enabledGlobalBlur").toBool();
+        this->onBlurEnableChanged(m_global_blur_enable && !m_low_end_mode);
 
         if (!KWindowEffects::isEffectAvailable(KWindowEffects::BlurBehind))
             confirmBlurEnableDelay();
@@ -86,7 +104,7 @@ bool BlurHelper::eventFilter(QObject *obj, QEvent *e)
     }
     case QEvent::Hide: {
         //QWidget* widget = qobject_cast<QWidget*>(obj);
-        KWindowEffects::enableBlurBehind(widget->winId(), false);
+        enableBlurBehind(widget->winId(), false);
     }
 
     default:
@@ -113,6 +131,9 @@ void BlurHelper::registerWidget(QWidget *widget)
     if (!QX11Info::isPlatformX11())
         return;
 
+    if (m_low_end_mode)
+        return;
+
     if (!KWindowEffects::isEffectAvailable(KWindowEffects::BlurBehind))
         return;
 
@@ -174,7 +195,7 @@ void BlurHelper::unregisterWidget(QWidget *widget)
     m_blur_widgets.removeOne(widget);
     widget->removeEventFilter(this);
     if (widget->winId() > 0)
-        KWindowEffects::enableBlurBehind(widget->winId(), false);
+        enableBlurBehind(widget->winId(), false);
 }
 #endif
 
@@ -217,13 +238,11 @@ void BlurHelper::onBlurEnableChanged(bool enable)
     } else {
         qApp->setProperty("blurEnable", false);
     }
-    for (auto widget : qApp->allWidgets()) {
-        widget->update();
-        if (m_blur_widgets.contains(widget)) {
-            if (widget->winId() > 0)
-                KWindowEffects::enableBlurBehind(widget->winId(), enable);
-        }
+    for (auto widget : m_blur_widgets) {
+        if (widget->winId() > 0)
+            enableBlurBehind(widget->winId(), enable);
     }
+    ThemeChangeTransaction::requestRepaint();
 //    QTimer::singleShot(100, this, [=](){
 //        for (auto widget : m_blur_widgets) {
 //            if (!widget)
@@ -234,6 +253,35 @@ void BlurHelper::onBlurEnableChanged(bool enable)
 //    });
 }
 
+void BlurHelper::onLowEndModeChanged(bool lowEndMode)
+{
+    if (m_low_end_mode == lowEndMode)
+        return;
+
+    if (lowEndMode) {
+        // unregister before m_low_end_mode is set, for blur behind to be removed.
+        for (auto widget : m_blur_widgets) {
+            widget->removeEventFilter(this);
+            disconnect(widget, &QWidget::destroyed, this, nullptr);
+            if (widget->testAttribute(Qt::WA_WState_Created))
+                enableBlurBehind(widget->winId(), false);
+        }
+        m_blur_widgets.clear();
+        m_update_list.clear();
+        m_low_end_mode = true;
+        // this also updates all widgets.
+        onBlurEnableChanged(false);
+        return;
+    }
+
+    m_low_end_mode = false;
+    for (auto widget : qApp->allWidgets()) {
+        if (widget->isWindow() && widget->testAttribute(Qt::WA_TranslucentBackground))
+            registerWidget(widget);
+    }
+    onBlurEnableChanged(m_global_blur_enable);
+}
+
 void BlurHelper::onWidgetDestroyed(QWidget *widget)
 {
     widget->removeEventFilter(this);
@@ -270,18 +318,14 @@ void BlurHelper::delayUpdate(QWidget *w, bool updateBlurRegionOnly)
                 if (!widget->styleSheet().isEmpty() || qApp->styleSheet().contains("QMenu")) {
                     break;
                 }
-                QPainterPath path;
-                path.addRoundedRect(widget->rect().adjusted(+5,+5,-5,-5), 6, 6);
-                KWindowEffects::enableBlurBehind(widget->winId(), true, path.toFillPolygon().toPolygon());
+                enableBlurBehind(widget->winId(), true, roundedRectRegion(widget->rect().adjusted(+5,+5,-5,-5), 6, 6));
                 if (!updateBlurRegionOnly)
                     widget->update();
                 break;
             }
 
             if (widget->inherits("QTipLabel")) {
-                QPainterPath path;
-                path.addRoundedRect(widget->rect().adjusted(+3,+3,-3,-3),4, 4);
-                KWindowEffects::enableBlurBehind(widget->winId(), true, path.toFillPolygon().toPolygon());
+                enableBlurBehind(widget->winId(), true, roundedRectRegion(widget->rect().adjusted(+3,+3,-3,-3), 4, 4));
                 if (!updateBlurRegionOnly)
                     widget->update();
                 break;
@@ -294,12 +338,12 @@ void BlurHelper::delayUpdate(QWidget *w, bool updateBlurRegionOnly)
             //qDebug()<<widget->metaObject()->className()<<widget->geometry()<<widget->mask();
             if (!region.isEmpty()) {
                 //qDebug()<<"blur region"<<region;
-                KWindowEffects::enableBlurBehind(widget->winId(), true, region);
+                enableBlurBehind(widget->winId(), true, region);
                 if (!updateBlurRegionOnly)
                     widget->update();
             } else {
                 //qDebug()<<widget->mask();
-                KWindowEffects::enableBlurBehind(widget->winId(), true, widget->mask());
+                enableBlurBehind(widget->winId(), true, widget->mask());
                 if (!updateBlurRegionOnly)
                     widget->update(widget->mask());
             }
@@ -329,7 +373,7 @@ void BlurHelper::confirmBlurEnableDelay()
             widget->update();
             if (m_blur_widgets.contains(widget)) {
                 if (widget->winId() > 0)
-                    KWindowEffects::enableBlurBehind(widget->winId(), enable);
+                    enableBlurBehind(widget->winId(), enable);
             }
         }
 //        QTimer::singleShot(100, this, [=](){
@@ -59,6 +59,14 @@ protected:
      */
     void confirmBlurEnableDelay();
 
+    /*!
+     * \brief onLowEndModeChanged
+     * \details
+     * org.ukui.style "low-end-mode" turns blur off and drops every registered
+     * widget. When it is turned off, all widgets are registered again.
+     */
+    void onLowEndModeChanged(bool lowEndMode);
+
 private:
     QList<QWidget *> m_blur_widgets;
 
@@ -66,6 +74,8 @@ private:
     QTimer m_timer;
 
     bool m_blur_enable = true;
+    bool m_global_blur_enable = true;
+    bool m_low_end_mode = false;
 };
 
 #endif // BLURHELPER_H
@@ -23,6 +23,8 @@
 #include "proxy-style-plugin.h"
 #include "proxy-style.h"
 #include "ukui-style-settings.h"
+#include "theme-bundle.h"
+#include "theme-change-transaction.h"
 
 #include "application-style-settings.h"
 
@@ -30,6 +32,7 @@
 
 #include <QApplication>
 #include <QStyleFactory>
+#include <QTimer>
 #include <QWidget>
 
 #include <QDebug>
@@ -39,9 +42,30 @@ using namespace UKUI;
 ProxyStylePlugin::ProxyStylePlugin()
 {
     if (UKUIStyleSettings::isSchemaInstalled("org.ukui.style")) {
-        auto settings = UKUIStyleSettings::globalInstance();
-        connect(settings, &UKUIStyleSettings::changed, this, [=](const QString &key) {
-            if (key == "styleName") {
+        // the style is created from the bundle, the settings are only needed for changes.
+        if (ThemeBundle::globalInstance()->isValid())
+            QTimer::singleShot(THEME_BUNDLE_WATCH_DELAY, this, &ProxyStylePlugin::watchSettings);
+        else
+            watchSettings();
+    }
+}
+
+/*!
+ * \brief ProxyStylePlugin::watchSettings
+ * \details
+ * follows the style and palette changes of org.ukui.style. A plugin loaded
+ * with a valid theme bundle calls this after startup, it applies the
+ * settings changed since the bundle was written.
+ */
+void ProxyStylePlugin::watchSettings()
+{
+    auto settings = UKUIStyleSettings::globalInstance();
+    auto onSettingsChanged = [=](const QString &key) {
+        // this plugin reads its own copy of the bundle.
+        ThemeBundle::globalInstance()->invalidate();
+
+        if (key == "styleName") {
+            ThemeChangeTransaction::schedule(ThemeChangeTransaction::Style, key, this, [=]() {
                 if (blackList().contains(qAppName()) || qAppName() == "biometric-manager" || qAppName() == "kylin-software-center.py")
                     return;
 
@@ -111,16 +135,19 @@ ProxyStylePlugin::ProxyStylePlugin()
                     break;
                 }
                 QApplication::setPalette(palette);
-            }
+            });
+        }
 
-            if (key == "systemPalette") {
+        if (key == "systemPalette" || key == "useSystemPalette") {
+            ThemeChangeTransaction::schedule(ThemeChangeTransaction::Palette, "systemPalette", this, [=]() {
                 onSystemPaletteChanged();
-            }
-            if (key == "useSystemPalette") {
-                onSystemPaletteChanged();
-            }
-        });
-    }
+            });
+        }
+    };
+    connect(settings, &UKUIStyleSettings::changed, this, onSettingsChanged);
+
+    for (auto key : ThemeBundle::globalInstance()->outdatedSettings())
+        onSettingsChanged(key);
 }
 
 QStyle *ProxyStylePlugin::create(const QString &key)
@@ -130,8 +157,12 @@ QStyle *ProxyStylePlugin::create(const QString &key)
     if (key == "ukui") {
         //FIXME:
         //get current style, fusion for invalid.
-        if (UKUIStyleSettings::isSchemaInstalled("org.ukui.style")) {
-            m_current_style_name = UKUIStyleSettings::globalInstance()->get("styleName").toString();
+        auto bundle = ThemeBundle::globalInstance();
+        if (bundle->isValid() || UKUIStyleSettings::isSchemaInstalled("org.ukui.style")) {
+            if (bundle->isValid())
+                m_current_style_name = bundle->setting("styleName").toString();
+            else
+                m_current_style_name = UKUIStyleSettings::globalInstance()->get("styleName").toString();
             if (m_current_style_name == "ukui-default" || m_current_style_name == "ukui-dark"
                     || m_current_style_name == "ukui-white" || m_current_style_name == "ukui-black"
                     || m_current_style_name == "ukui-light" || m_current_style_name == "ukui") {
@@ -174,7 +205,9 @@ void ProxyStylePlugin::onSystemPaletteChanged()
         auto palette = qvariant_cast<QPalette>(data);
         QApplication::setPalette(palette);
     } else {
+        // a style changed in the same transaction might have set it already.
         auto palette = QApplication::style()->standardPalette();
-        QApplication::setPalette(palette);
+        if (palette != QApplication::palette())
+            QApplication::setPalette(palette);
     }
 }
@@ -39,6 +39,7 @@ public:
     const QStringList blackList();
 
 protected:
+    void watchSettings();
     void onSystemPaletteChanged();
 
 signals:
@@ -28,6 +28,7 @@
 #include "application-style-settings.h"
 
 #include "ukui-style-settings.h"
+#include "paint-statistics.h"
 
 #include <QApplication>
 #include <QMenu>
@@ -99,6 +100,8 @@ ProxyStyle::ProxyStyle(const QString &key) : QProxyStyle(key == nullptr? "fusion
 //    m_gesture_helper = new GestureHelper(this);
     m_window_manager = new WindowManager(this);
 
+    PaintStatistics::globalInstance()->exportOnSessionBus("proxy");
+
     if (!baseStyle()->inherits("Qt5UKUIStyle")) {
         m_blur_helper->onBlurEnableChanged(false);
     }
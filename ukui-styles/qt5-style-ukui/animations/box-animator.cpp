@@ -21,6 +21,7 @@
  */
 
 #include "box-animator.h"
+#include "animation-helper.h"
 
 #include <QComboBox>
 
@@ -57,10 +58,12 @@ bool BoxAnimator::bindWidget(QWidget *w)
     addAnimation(m_sunken);
 
     connect(m_sunken, &QVariantAnimation::valueChanged, w, [=]() {
-       w->repaint();
+       if (AnimationHelper::shouldAnimate(w, m_sunken))
+           w->repaint();
     });
     connect(m_mouseover, &QVariantAnimation::valueChanged, w, [=]() {
-       w->repaint();
+       if (AnimationHelper::shouldAnimate(w, m_mouseover))
+           w->repaint();
     });
     connect(m_sunken, &QVariantAnimation::finished, w, [=]() {
        w->repaint();
@@ -21,6 +21,7 @@
  */
 
 #include "button-animator.h"
+#include "animation-helper.h"
 #include <QToolButton>
 #include <QPushButton>
 #include <QComboBox>
@@ -60,10 +61,12 @@ bool ButtonAnimator::bindWidget(QWidget *w)
     addAnimation(m_sunken);
 
     connect(m_sunken, &QVariantAnimation::valueChanged, w, [=]() {
-       w->update();
+       if (AnimationHelper::shouldAnimate(w, m_sunken))
+           w->update();
     });
     connect(m_mouseover, &QVariantAnimation::valueChanged, w, [=]() {
-       w->update();
+       if (AnimationHelper::shouldAnimate(w, m_mouseover))
+           w->update();
     });
     connect(m_sunken, &QVariantAnimation::finished, w, [=]() {
        w->update();
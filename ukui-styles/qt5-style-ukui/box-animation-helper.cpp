@@ -41,25 +41,24 @@ bool BoxAnimationHelper::registerWidget(QWidget *w)
     }
     else
     {
-        m_animators->insert(w, animator);
+        setSlotAnimator(w, BoxSlot, animator);
     }
     return result;
 }
 
 bool BoxAnimationHelper::unregisterWidget(QWidget *w)
 {
-    auto animator= m_animators->value(w);
+    auto animator = takeSlotAnimator(w, BoxSlot);
     bool result = false;
     if (animator) {
         result = animator->unboundWidget();
         delete animator;
     }
-    m_animators->remove(w);
     return result;
 }
 
 AnimatorIface *BoxAnimationHelper::animator(const QWidget *w)
 {
-    return m_animators->value(w);
+    return slotAnimator(w, BoxSlot);
 }
 
@@ -40,24 +40,23 @@ bool ButtonAnimationHelper::registerWidget(QWidget *w)
     }
     else
     {
-        m_animators->insert(w, animator);
+        setSlotAnimator(w, ButtonSlot, animator);
     }
     return result;
 }
 
 bool ButtonAnimationHelper::unregisterWidget(QWidget *w)
 {
-    auto animator= m_animators->value(w);
+    auto animator = takeSlotAnimator(w, ButtonSlot);
     bool result = false;
     if (animator) {
         result = animator->unboundWidget();
         delete animator;
     }
-    m_animators->remove(w);
     return result;
 }
 
 AnimatorIface *ButtonAnimationHelper::animator(const QWidget *w)
 {
-    return m_animators->value(w);
+    return slotAnimator(w, ButtonSlot);
 }
@@ -0,0 +1,178 @@
+/*
+ * Qt5-UKUI's Library
+ *
+ * Copyright (C) 2020, Tianjin KYLIN Information Technology Co., Ltd.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this library.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * Authors: Yue Lan <lanyue@kylinos.cn>
+ *
+ */
+
+#include "paint-recorder.h"
+#include "paint-statistics.h"
+
+#include <QStyleOption>
+#include <QPainter>
+#include <QWidget>
+#include <QIcon>
+
+#define PAINT_RECORDING_CACHE_SIZE 4 * 1024 * 1024
+
+static PaintRecorder *global_instance = nullptr;
+
+PaintRecorder *PaintRecorder::globalInstance()
+{
+    if (!global_instance)
+        global_instance = new PaintRecorder;
+    return global_instance;
+}
+
+PaintRecorder::PaintRecorder()
+{
+    m_pictures.setMaxCost(PAINT_RECORDING_CACHE_SIZE);
+}
+
+static bool canRecord(const QStyleOption *option, const QPainter *painter)
+{
+    // never record into a picture being recorded, and skip unusual painters.
+    return option && !option->rect.isEmpty() && painter->device()->devType() != QInternal::Picture
+            && painter->transform().type() <= QTransform::TxTranslate;
+}
+
+static void addCommonFields(int element, const QStyleOption *option, const QPainter *painter,
+                            const QWidget *widget, PaintRecorder::Key *key)
+{
+    key->fields << element << option->type << option->version << option->rect.width() << option->rect.height()
+                << int(option->state) << int(option->direction) << int(option->palette.currentColorGroup());
+    // compared by its brushes, palettes are copied and modified for single paints.
+    key->palette = option->palette;
+    key->font = painter->font();
+    // labels are laid out with the option's font metrics.
+    key->fontMetrics = option->fontMetrics;
+    key->iconTheme = QIcon::themeName();
+
+    if (widget) {
+        key->widgetClass = widget->metaObject();
+        for (auto property : {"isWindowButton", "useButtonPalette", "isImportant", "useIconHighlightEffect",
+             "iconHighlightEffectMode", "setIconHighlightEffectDefaultColor",
+             "setIconHighlightEffectHoverColor", "fillIconSymbolicColor", "skipHighlightIconEffect"}) {
+            key->properties << widget->property(property);
+        }
+    }
+}
+
+static qint64 iconKey(const QIcon &icon)
+{
+    return icon.isNull()? 0: icon.cacheKey();
+}
+
+bool PaintRecorder::makeKey(QStyle::ControlElement element, const QStyleOption *option,
+                            const QPainter *painter, const QWidget *widget, Key *key)
+{
+    if (!canRecord(option, painter))
+        return false;
+
+    switch (element) {
+    case QStyle::CE_PushButtonLabel: {
+        auto button = qstyleoption_cast<const QStyleOptionButton *>(option);
+        if (!button)
+            return false;
+        addCommonFields(element, option, painter, widget, key);
+        key->fields << iconKey(button->icon) << button->iconSize.width() << button->iconSize.height()
+                    << int(button->features);
+        key->text = button->text;
+        return true;
+    }
+    case QStyle::CE_ToolButtonLabel: {
+        auto toolButton = qstyleoption_cast<const QStyleOptionToolButton *>(option);
+        if (!toolButton)
+            return false;
+        addCommonFields(element, option, painter, widget, key);
+        key->fields << iconKey(toolButton->icon) << toolButton->iconSize.width() << toolButton->iconSize.height()
+                    << int(toolButton->toolButtonStyle) << int(toolButton->arrowType) << int(toolButton->features);
+        key->optionFont = toolButton->font;
+        key->text = toolButton->text;
+        return true;
+    }
+    case QStyle::CE_MenuItem: {
+        auto menuItem = qstyleoption_cast<const QStyleOptionMenuItem *>(option);
+        if (!menuItem)
+            return false;
+        addCommonFields(element, option, painter, widget, key);
+        key->fields << iconKey(menuItem->icon) << int(menuItem->menuItemType) << int(menuItem->checkType)
+                    << int(menuItem->checked) << int(menuItem->menuHasCheckableItems) << menuItem->maxIconWidth
+                    << menuItem->tabWidth << menuItem->menuRect.width();
+        key->optionFont = menuItem->font;
+        key->text = menuItem->text;
+        return true;
+    }
+    case QStyle::CE_HeaderSection:
+    case QStyle::CE_HeaderLabel: {
+        auto header = qstyleoption_cast<const QStyleOptionHeader *>(option);
+        if (!header)
+            return false;
+        addCommonFields(element, option, painter, widget, key);
+        key->fields << iconKey(header->icon) << header->section << int(header->textAlignment)
+                    << int(header->iconAlignment) << int(header->position) << int(header->selectedPosition)
+                    << int(header->sortIndicator) << int(header->orientation);
+        key->text = header->text;
+        return true;
+    }
+    default:
+        return false;
+    }
+}
+
+void PaintRecorder::draw(QPainter *painter, const Key &key, const QRect &rect,
+                         const std::function<void(QPainter *)> &paint)
+{
+    auto cachedPicture = m_pictures.object(key);
+    PaintStatistics::countCache(PaintStatistics::PictureCacheHits, cachedPicture != nullptr);
+    if (cachedPicture) {
+        painter->drawPicture(rect.topLeft(), *cachedPicture);
+        return;
+    }
+
+    auto picture = new QPicture;
+    QPainter p(picture);
+    p.setFont(painter->font());
+    p.setPen(painter->pen());
+    p.setBrush(painter->brush());
+    p.setRenderHints(painter->renderHints());
+    p.setLayoutDirection(painter->layoutDirection());
+    p.translate(-rect.topLeft());
+    paint(&p);
+    p.end();
+
+    painter->drawPicture(rect.topLeft(), *picture);
+    m_pictures.insert(key, picture, qMax(1, int(picture->size())));
+}
+
+bool operator==(const PaintRecorder::Key &a, const PaintRecorder::Key &b)
+{
+    return a.fields == b.fields && a.widgetClass == b.widgetClass && a.properties == b.properties
+            && a.text == b.text && a.iconTheme == b.iconTheme && a.font == b.font
+            && a.optionFont == b.optionFont && a.fontMetrics == b.fontMetrics && a.palette == b.palette;
+}
+
+uint qHash(const PaintRecorder::Key &key, uint seed)
+{
+    uint hash = qHashRange(key.fields.constBegin(), key.fields.constEnd(), seed);
+    hash ^= qHash(key.widgetClass, seed);
+    hash ^= qHash(key.palette.color(QPalette::Text).rgba(), seed) ^ qHash(key.palette.color(QPalette::ButtonText).rgba(), seed);
+    if (!key.text.isEmpty())
+        hash ^= qHash(key.text, seed);
+    return hash;
+}
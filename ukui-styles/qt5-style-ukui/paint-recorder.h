@@ -0,0 +1,100 @@
+/*
+ * Qt5-UKUI's Library
+ *
+ * Copyright (C) 2020, Tianjin KYLIN Information Technology Co., Ltd.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this library.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * Authors: Yue Lan <lanyue@kylinos.cn>
+ *
+ */
+
+#ifndef PAINTRECORDER_H
+#define PAINTRECORDER_H
+
+#include <QCache>
+#include <QPicture>
+#include <QStyle>
+#include <QFont>
+#include <QFontMetrics>
+#include <QPalette>
+#include <QVariant>
+#include <QVarLengthArray>
+#include <functional>
+
+/*!
+ * \brief The PaintRecorder class
+ * \details
+ * Toolbars, menus and headers often contain many controls whose options
+ * only differ in position. When paint recording is enabled (org.ukui.style
+ * "paint-recording"), the painter commands of such a control are recorded
+ * into a QPicture relative to the control's rect, and replayed for every
+ * control with an identical option. Pictures keep vector commands, so the
+ * replay is rasterized at the target's device pixel ratio.
+ *
+ * Only labels with text and icons are recorded, they are expensive enough
+ * to pay for building the key and replaying. Elements which drive
+ * animations or have side effects are never recorded. The key covers every
+ * option field the element reads, the colors of the option's palette
+ * rather than its cacheKey(), which changes for every modified copy, the
+ * option's font metrics, the widget's class, the widget properties read by the style and HighLightEffect, the
+ * painter's font and the icon theme.
+ */
+class PaintRecorder
+{
+public:
+    struct Key {
+        QVarLengthArray<qint64, 24> fields;
+        const QMetaObject *widgetClass = nullptr;
+        QVarLengthArray<QVariant, 9> properties;
+        QString text;
+        QString iconTheme;
+        QFont font;
+        QFont optionFont;
+        QFontMetrics fontMetrics = QFontMetrics(QFont());
+        QPalette palette;
+    };
+
+    static PaintRecorder *globalInstance();
+
+    /*!
+     * \brief makeKey
+     * \return false if this element should be painted directly.
+     */
+    static bool makeKey(QStyle::ControlElement element, const QStyleOption *option,
+                        const QPainter *painter, const QWidget *widget, Key *key);
+
+    /*!
+     * \brief draw
+     * \param painter
+     * \param key from makeKey().
+     * \param rect the option rect.
+     * \param paint paints the element with its original option onto given painter.
+     * \details
+     * replays the picture of key at rect, records it with paint first when it
+     * is not cached.
+     */
+    void draw(QPainter *painter, const Key &key, const QRect &rect,
+              const std::function<void(QPainter *)> &paint);
+
+private:
+    PaintRecorder();
+
+    QCache<Key, QPicture> m_pictures;
+};
+
+bool operator==(const PaintRecorder::Key &a, const PaintRecorder::Key &b);
+uint qHash(const PaintRecorder::Key &key, uint seed = 0);
+
+#endif // PAINTRECORDER_H
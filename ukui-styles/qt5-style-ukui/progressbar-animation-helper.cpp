@@ -21,52 +21,168 @@
  */
 
 #include "progressbar-animation-helper.h"
+#include "progressbar-animation.h"
+#include "animation-helper.h"
+#include "paint-statistics.h"
+
+#include <QWidget>
+#include <QWindow>
+#include <QEvent>
+#include <QCoreApplication>
 
 ProgressBarAnimationHelper::ProgressBarAnimationHelper(QObject *parent) : QObject(parent)
 {
-    animations = new QHash<QObject *, QVariantAnimation *>();
+    m_clock = new ProgressBarAnimation(this);
+    connect(m_clock, &QVariantAnimation::valueChanged, this, &ProgressBarAnimationHelper::updateTargets);
 }
 
 
 
 ProgressBarAnimationHelper::~ProgressBarAnimationHelper()
 {
-    delete animations;
+    m_clock->stop();
 }
 
 
 
-void ProgressBarAnimationHelper::startAnimation(QVariantAnimation *animation)
+void ProgressBarAnimationHelper::startAnimation(QObject *target)
 {
-    stopAnimation(animation->parent());
-    connect(animation, SIGNAL(destroyed()), SLOT(_q_removeAnimation()), Qt::UniqueConnection);
-    animations->insert(animation->parent(), animation);
-    animation->start();
+    if (!target)
+        return;
+
+    if (!m_targets.contains(target)) {
+        m_targets.insert(target);
+        connect(target, &QObject::destroyed, this, &ProgressBarAnimationHelper::_q_removeTarget, Qt::UniqueConnection);
+    }
+
+    if (m_clock->state() == QAbstractAnimation::Paused)
+        resumeClock();
+    else if (m_clock->state() != QAbstractAnimation::Running)
+        m_clock->start();
 }
 
 
 
 void ProgressBarAnimationHelper::stopAnimation(QObject *target)
 {
-    QVariantAnimation *animation = animations->take(target);
-    if (animation) {
-        animation->stop();
-        delete animation;
+    if (!target || !m_targets.remove(target))
+        return;
+
+    disconnect(target, &QObject::destroyed, this, &ProgressBarAnimationHelper::_q_removeTarget);
+    if (m_targets.isEmpty())
+        m_clock->stop();
+}
+
+
+
+qreal ProgressBarAnimationHelper::currentValue() const
+{
+    return m_clock->phase();
+}
+
+
+
+void ProgressBarAnimationHelper::_q_removeTarget(QObject *target)
+{
+    m_targets.remove(target);
+    if (m_targets.isEmpty())
+        m_clock->stop();
+}
+
+
+
+void ProgressBarAnimationHelper::updateTargets()
+{
+    PaintStatistics::count(PaintStatistics::ProgressClockTicks);
+
+    bool hasExposedTarget = false;
+    auto it = m_targets.begin();
+    while (it != m_targets.end()) {
+        QObject *target = *it;
+        if (target->isWidgetType()) {
+            auto widget = static_cast<QWidget *>(target);
+            if (!widget->isVisible()) {
+                // a hidden bar will be registered again at its next paint.
+                disconnect(target, &QObject::destroyed, this, &ProgressBarAnimationHelper::_q_removeTarget);
+                it = m_targets.erase(it);
+                continue;
+            }
+            if (AnimationHelper::isWidgetExposed(widget)) {
+                widget->update();
+                hasExposedTarget = true;
+            }
+        } else {
+            QEvent event(QEvent::StyleAnimationUpdate);
+            QCoreApplication::sendEvent(target, &event);
+            hasExposedTarget = true;
+        }
+        ++it;
+    }
+
+    if (m_targets.isEmpty()) {
+        m_clock->stop();
+    } else if (!hasExposedTarget) {
+        // every bar is in a minimized or covered window, the clock will be
+        // resumed by the first bar painted after its window is exposed again.
+        pauseClock();
+    }
+}
+
+
+
+bool ProgressBarAnimationHelper::eventFilter(QObject *obj, QEvent *e)
+{
+    switch (e->type()) {
+    case QEvent::Expose: {
+        auto window = qobject_cast<QWindow *>(obj);
+        if (window && window->isExposed())
+            resumeClock();
+        break;
+    }
+    case QEvent::WindowStateChange:
+    case QEvent::Show: {
+        auto widget = qobject_cast<QWidget *>(obj);
+        if (widget && AnimationHelper::isWidgetExposed(widget))
+            resumeClock();
+        break;
     }
+    default:
+        break;
+    }
+    return false;
 }
 
 
 
-QVariantAnimation* ProgressBarAnimationHelper::animation(QObject *target)
+void ProgressBarAnimationHelper::pauseClock()
 {
-    return animations->value(target);
+    m_clock->pause();
+
+    for (auto target : m_targets) {
+        if (!target->isWidgetType())
+            continue;
+        auto topLevel = static_cast<QWidget *>(target)->window();
+        if (m_watched_windows.contains(topLevel))
+            continue;
+        topLevel->installEventFilter(this);
+        m_watched_windows << topLevel;
+        if (auto window = topLevel->windowHandle()) {
+            window->installEventFilter(this);
+            m_watched_windows << window;
+        }
+    }
 }
 
 
 
-void ProgressBarAnimationHelper::_q_removeAnimation()
+void ProgressBarAnimationHelper::resumeClock()
 {
-    QObject *animation = this->sender();
-    if (animation)
-        animations->remove(animation->parent());
+    for (auto obj : m_watched_windows) {
+        if (obj)
+            obj->removeEventFilter(this);
+    }
+    m_watched_windows.clear();
+
+    if (m_clock->state() == QAbstractAnimation::Paused)
+        m_clock->resume();
 }
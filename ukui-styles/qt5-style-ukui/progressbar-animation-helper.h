@@ -24,11 +24,21 @@
 #define PROGRESSBARANIMATIONHELPER_H
 
 #include <QObject>
-#include <QVariantAnimation>
-#include <QHash>
-#include "progressbar-animation.h"
+#include <QSet>
+#include <QPointer>
 
+class ProgressBarAnimation;
 
+/*!
+ * \brief The ProgressBarAnimationHelper class
+ * \details
+ * Drives all indeterminate progress bars with one shared clock.
+ * A bar is registered when it is painted in indeterminate state, and all
+ * registered bars which are visible are updated together on each tick of
+ * the clock, so they are repainted once per frame in the same paint pass.
+ * The clock only runs while there is at least one registered bar, and it
+ * is paused while none of the registered bars' windows is exposed.
+ */
 class ProgressBarAnimationHelper : public QObject
 {
     Q_OBJECT
@@ -36,15 +46,35 @@ public:
     ProgressBarAnimationHelper(QObject *parent = nullptr);
     virtual ~ProgressBarAnimationHelper();
 
-    void startAnimation(QVariantAnimation *animation);
+    void startAnimation(QObject *target);
     void stopAnimation(QObject *target);
-    QVariantAnimation* animation(QObject *target);
+
+    /*!
+     * \brief currentValue
+     * \return current phase of the shared clock, from 0 to 1 and back.
+     */
+    qreal currentValue() const;
+
+    bool eventFilter(QObject *obj, QEvent *e) override;
 
 public slots:
-    void _q_removeAnimation();
+    void _q_removeTarget(QObject *target);
+
+protected slots:
+    void updateTargets();
+
+protected:
+    void pauseClock();
+    void resumeClock();
 
 private:
-    QHash<QObject*, QVariantAnimation*> *animations;
+    ProgressBarAnimation *m_clock = nullptr;
+    QSet<QObject *> m_targets;
+    /*!
+     * \brief m_watched_windows
+     * top-level widgets and their windows watched while the clock is paused.
+     */
+    QList<QPointer<QObject>> m_watched_windows;
 };
 
 #endif // PROGRESSBARANIMATIONHELPER_H
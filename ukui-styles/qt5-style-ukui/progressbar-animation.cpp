@@ -29,25 +29,20 @@ ProgressBarAnimation::ProgressBarAnimation(QObject *parent) : QVariantAnimation
 
 
 
-QWidget *ProgressBarAnimation::target()
+qreal ProgressBarAnimation::phase() const
 {
-    return qobject_cast<QWidget*>(parent());
+    qreal value = currentValue().toReal();
+    return 1.0 - qAbs(2 * value - 1.0);
 }
 
 
 
 void ProgressBarAnimation::init()
 {
+    // a full loop contains a forward and a backward sweep, 2500ms each.
     this->setStartValue(0.0);
     this->setEndValue(1.0);
-    this->setDuration(2500);
-    this->setDirection(QAbstractAnimation::Forward);
+    this->setDuration(5000);
+    this->setLoopCount(-1);
     this->setEasingCurve(QEasingCurve::Linear);
-
-    connect(this, &QVariantAnimation::valueChanged, target(), [=](QVariant value) {
-        target()->repaint();
-    });
-    connect(this, &QVariantAnimation::finished, target(), [=]() {
-       target()->repaint();
-    });
 }
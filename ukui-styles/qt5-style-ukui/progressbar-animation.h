@@ -25,16 +25,24 @@
 
 #include <QObject>
 #include <QVariantAnimation>
-#include <QProgressBar>
-
-
 
+/*!
+ * \brief The ProgressBarAnimation class
+ * \details
+ * The phase clock of indeterminate progress bars. There is only one
+ * instance, owned by ProgressBarAnimationHelper, and every busy indicator
+ * samples phase() when it is painted.
+ */
 class ProgressBarAnimation : public QVariantAnimation
 {
 public:
-    ProgressBarAnimation(QObject *parent);
+    ProgressBarAnimation(QObject *parent = nullptr);
 
-    QWidget *target();
+    /*!
+     * \brief phase
+     * \return position of the moving chunk, it goes from 0 to 1 and back.
+     */
+    qreal phase() const;
 
 private:
     void init();
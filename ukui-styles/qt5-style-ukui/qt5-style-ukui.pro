@@ -36,7 +36,9 @@ SOURCES += \
     shadow-helper.cpp \
     tab-widget-animation-helper.cpp \
     scrollbar-animation-helper.cpp \
-    qt5-ukui-style-helper.cpp
+    qt5-ukui-style-helper.cpp \
+    sub-rect-memo.cpp \
+    paint-recorder.cpp
 
 HEADERS += \
     box-animation-helper.h \
@@ -48,7 +50,9 @@ HEADERS += \
     shadow-helper.h \
     tab-widget-animation-helper.h \
     scrollbar-animation-helper.h \
-    qt5-ukui-style-helper.h
+    qt5-ukui-style-helper.h \
+    sub-rect-memo.h \
+    paint-recorder.h
 DISTFILES += qt5-style-ukui.json 
 
 unix {
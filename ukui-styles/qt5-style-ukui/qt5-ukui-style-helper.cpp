@@ -22,11 +22,17 @@
 
 #include "qt5-ukui-style-helper.h"
 #include "ukui-style-settings.h"
+#include "rounded-rect-region.h"
+#include "paint-statistics.h"
+#include "disk-image-cache.h"
 
 #include <QPainter>
 #include <QStyleOption>
 #include <QWidget>
 #include <QPainterPath>
+#include <QPixmapCache>
+#include <QCache>
+#include <QCryptographicHash>
 
 #include <KWindowEffects>
 
@@ -35,6 +41,11 @@
 #include <QDebug>
 #include "black-list.h"
 
+#define DIAL_LINES_CACHE_SIZE 16
+#define ICON_ACTUAL_SIZE_CACHE_SIZE 256
+#define PALETTE_KEY_CACHE_SIZE 64
+#define NINE_SLICE_KEY_CACHE_SIZE 256
+
 extern void qt_blurImage(QImage &blurImage, qreal radius, bool quality, int transposed);
 
 static inline qreal mixQreal(qreal a, qreal b, qreal bias)
@@ -145,9 +156,7 @@ void drawMenuPrimitive(const QStyleOption *option, QPainter *painter, const QWid
 
 const QRegion getRoundedRectRegion(const QRect &rect, qreal radius_x, qreal radius_y)
 {
-    QPainterPath path;
-    path.addRoundedRect(rect, radius_x, radius_y);
-    return path.toFillPolygon().toPolygon();
+    return roundedRectRegion(rect, radius_x, radius_y);
 }
 
 qreal calcRadialPos(const QStyleOptionSlider *dial, int postion)
@@ -163,7 +172,32 @@ qreal calcRadialPos(const QStyleOptionSlider *dial, int postion)
     return a;
 }
 
+static QPolygonF realCalcLines(const QStyleOptionSlider *dial, int offset);
+
+/*!
+ * \brief calcLines
+ * \details
+ * the tick lines only depend on dial's size, range, tick interval, page step
+ * and wrapping, they are kept in a small cache instead of evaluating sin and cos
+ * for every notch on every paint.
+ */
 QPolygonF calcLines(const QStyleOptionSlider *dial, int offset)
+{
+    static QCache<QString, QPolygonF> cache(DIAL_LINES_CACHE_SIZE);
+    const QString key = QString("%1x%2_%3_%4_%5_%6_%7_%8").arg(dial->rect.width()).arg(dial->rect.height())
+            .arg(dial->minimum).arg(dial->maximum).arg(dial->tickInterval).arg(dial->pageStep)
+            .arg(dial->dialWrapping).arg(offset);
+    auto cachedLines = cache.object(key);
+    PaintStatistics::countCache(PaintStatistics::DialLinesCacheHits, cachedLines != nullptr);
+    if (cachedLines)
+        return *cachedLines;
+
+    QPolygonF lines = realCalcLines(dial, offset);
+    cache.insert(key, new QPolygonF(lines));
+    return lines;
+}
+
+static QPolygonF realCalcLines(const QStyleOptionSlider *dial, int offset)
 {
     QPolygonF poly(0);
     int width = dial->rect.width();
@@ -205,6 +239,27 @@ QPolygonF calcLines(const QStyleOptionSlider *dial, int offset)
 
 
 
+/*!
+ * \brief iconActualSize
+ * \details
+ * QIcon::actualSize() of a theme icon looks up the theme entries of the icon,
+ * the result is cached by the icon, the current icon theme and the arguments.
+ */
+static QSize iconActualSize(const QIcon &icon, const QSize &size, QIcon::Mode mode, QIcon::State state)
+{
+    static QCache<QString, QSize> cache(ICON_ACTUAL_SIZE_CACHE_SIZE);
+    const QString key = QString("%1_%2_%3x%4_%5_%6").arg(icon.cacheKey()).arg(QIcon::themeName())
+            .arg(size.width()).arg(size.height()).arg(int(mode)).arg(int(state));
+    auto cachedSize = cache.object(key);
+    PaintStatistics::countCache(PaintStatistics::IconSizeCacheHits, cachedSize != nullptr);
+    if (cachedSize)
+        return *cachedSize;
+
+    const QSize actualSize = icon.actualSize(size, mode, state);
+    cache.insert(key, new QSize(actualSize));
+    return actualSize;
+}
+
 void tabLayout(const QStyleOptionTab *tab, const QWidget *widget, const QStyle *style, QRect *textRect, QRect *iconRect)
 {
     Q_ASSERT(textRect);
@@ -236,9 +291,9 @@ void tabLayout(const QStyleOptionTab *tab, const QWidget *widget, const QStyle *
         if (!iconSize.isValid()) {
             iconSize = QSize(iconExtent, iconExtent);
         }
-        QSize tabIconSize = tab->icon.actualSize(iconSize,
-                                                 (tab->state & QStyle::State_Enabled) ? QIcon::Normal : QIcon::Disabled,
-                                                 (tab->state & QStyle::State_Selected) ? QIcon::On : QIcon::Off);
+        QSize tabIconSize = iconActualSize(tab->icon, iconSize,
+                                           (tab->state & QStyle::State_Enabled) ? QIcon::Normal : QIcon::Disabled,
+                                           (tab->state & QStyle::State_Selected) ? QIcon::On : QIcon::Off);
         // High-dpi icons do not need adjustment; make sure tabIconSize is not larger than iconSize
         tabIconSize = QSize(qMin(tabIconSize.width(), iconSize.width()), qMin(tabIconSize.height(), iconSize.height()));
 
@@ -316,3 +371,302 @@ void drawArrow(const QStyle *style, const QStyleOptionToolButton *toolbutton,
     arrowOpt.rect = rect;
     style->drawPrimitive(pe, &arrowOpt, painter, widget);
 }
+
+// sprites are only blitted 1:1 onto whole device pixels, and never recorded
+// into a QPicture, which would pin them to its device pixel ratio.
+static bool canBlitSprite(QPainter *painter)
+{
+    if (painter->device()->devType() == QInternal::Picture)
+        return false;
+
+    const qreal ratio = painter->device()->devicePixelRatioF();
+    const QTransform &transform = painter->transform();
+    return transform.type() <= QTransform::TxTranslate
+            && transform.dx() == qRound(transform.dx()) && transform.dy() == qRound(transform.dy())
+            && ratio == qRound(ratio) && !painter->viewTransformEnabled()
+            && painter->compositionMode() == QPainter::CompositionMode_SourceOver
+            && !qApp->property("disableStyleSpriteCache").toBool();
+}
+
+// the sprite is only used when the footprint has room for its middle slices.
+static bool canDrawNineSlice(QPainter *painter, const QRect &footprint, int corner)
+{
+    const int size = 2 * corner + 1;
+    return footprint.width() >= size && footprint.height() >= size && canBlitSprite(painter);
+}
+
+// spriteKey identifies the shape, its colors, the corner size, the device
+// pixel ratio and the antialiasing of the sprite.
+static void blitNineSlice(QPainter *painter, const QRect &footprint, int corner, const QString &spriteKey,
+                          const std::function<void(QPainter *, const QRect &)> &paintShape)
+{
+    const int size = 2 * corner + 1;
+    const int d = qRound(painter->device()->devicePixelRatioF());
+    QPixmap sprite;
+    const bool spriteCached = QPixmapCache::find(spriteKey, &sprite);
+    PaintStatistics::countCache(PaintStatistics::SpriteCacheHits, spriteCached);
+    if (!spriteCached) {
+        QImage image;
+        if (DiskImageCache::globalInstance()->find(spriteKey, &image)) {
+            sprite = QPixmap::fromImage(image);
+        } else {
+            sprite = QPixmap(size * d, size * d);
+            sprite.setDevicePixelRatio(d);
+            sprite.fill(Qt::transparent);
+            QPainter p(&sprite);
+            p.setRenderHints(painter->renderHints());
+            paintShape(&p, QRect(0, 0, size, size));
+            p.end();
+            DiskImageCache::globalInstance()->insert(spriteKey, sprite.toImage());
+        }
+        QPixmapCache::insert(spriteKey, sprite);
+    }
+
+    const int x = footprint.x();
+    const int y = footprint.y();
+    const int w = footprint.width();
+    const int h = footprint.height();
+    const int c = corner;
+    const int cd = corner * d;
+
+    // a stretched 1px slice must not be blended with its neighbors.
+    const bool smooth = painter->testRenderHint(QPainter::SmoothPixmapTransform);
+    painter->setRenderHint(QPainter::SmoothPixmapTransform, false);
+
+    painter->drawPixmap(QRect(x, y, c, c), sprite, QRect(0, 0, cd, cd));
+    painter->drawPixmap(QRect(x + w - c, y, c, c), sprite, QRect(cd + d, 0, cd, cd));
+    painter->drawPixmap(QRect(x, y + h - c, c, c), sprite, QRect(0, cd + d, cd, cd));
+    painter->drawPixmap(QRect(x + w - c, y + h - c, c, c), sprite, QRect(cd + d, cd + d, cd, cd));
+
+    painter->drawPixmap(QRect(x + c, y, w - 2 * c, c), sprite, QRect(cd, 0, d, cd));
+    painter->drawPixmap(QRect(x + c, y + h - c, w - 2 * c, c), sprite, QRect(cd, cd + d, d, cd));
+    painter->drawPixmap(QRect(x, y + c, c, h - 2 * c), sprite, QRect(0, cd, cd, d));
+    painter->drawPixmap(QRect(x + w - c, y + c, c, h - 2 * c), sprite, QRect(cd + d, cd, cd, d));
+
+    painter->drawPixmap(QRect(x + c, y + c, w - 2 * c, h - 2 * c), sprite, QRect(cd, cd, d, d));
+
+    painter->setRenderHint(QPainter::SmoothPixmapTransform, smooth);
+}
+
+/*!
+ * \brief drawNineSlice
+ * \param painter
+ * \param footprint the integer rect covered by the shape, including its antialiased edge.
+ * \param corner size of the corner slices.
+ * \param key identifies the shape and all of its colors.
+ * \param paintShape paints the shape into a given footprint.
+ * \details
+ * Shapes whose middle row and column are uniform, such as rounded rects, are
+ * rasterized once into a (2 * corner + 1) square sprite kept in QPixmapCache
+ * and DiskImageCache, then painted as 4 corner blits and 5 stretched 1px
+ * slices. The key must be the same in every process.
+ *
+ * The shape is painted directly when the footprint is smaller than the
+ * sprite, or the sprite could not be placed on whole device pixels (non
+ * translating transform, fractional device pixel ratio).
+ * Set qApp property "disableStyleSpriteCache" to always paint directly.
+ */
+void drawNineSlice(QPainter *painter, const QRect &footprint, int corner, const QString &key,
+                   const std::function<void(QPainter *, const QRect &)> &paintShape)
+{
+    if (!canDrawNineSlice(painter, footprint, corner)) {
+        painter->save();
+        paintShape(painter, footprint);
+        painter->restore();
+        return;
+    }
+
+    QString spriteKey;
+    spriteKey.reserve(key.size() + 40);
+    spriteKey.append(QLatin1String("ukui_nine_slice_")).append(key)
+            .append(QLatin1Char('_')).append(QString::number(corner))
+            .append(QLatin1Char('_')).append(QString::number(qRound(painter->device()->devicePixelRatioF())));
+    if (painter->testRenderHint(QPainter::Antialiasing))
+        spriteKey.append(QLatin1String("_aa"));
+
+    blitNineSlice(painter, footprint, corner, spriteKey, paintShape);
+}
+
+// all parameters of a rounded rect sprite, without padding so it is hashed and
+// written into the key byte by byte.
+struct RoundedRectSprite
+{
+    qreal penWidth;
+    qreal xRadius;
+    qreal yRadius;
+    qreal left;
+    qreal top;
+    qreal right;
+    qreal bottom;
+    quint32 brushColor;
+    quint32 penColor;
+    qint32 capJoinStyle;
+    qint32 corner;
+    qint32 ratio;
+    qint32 antialiasing;
+};
+Q_STATIC_ASSERT(sizeof(RoundedRectSprite) == 7 * sizeof(qreal) + 6 * sizeof(qint32));
+
+static inline bool operator==(const RoundedRectSprite &a, const RoundedRectSprite &b)
+{
+    return memcmp(&a, &b, sizeof(RoundedRectSprite)) == 0;
+}
+
+static inline uint qHash(const RoundedRectSprite &sprite, uint seed = 0)
+{
+    return qHashBits(&sprite, sizeof(RoundedRectSprite), seed);
+}
+
+/*!
+ * \brief drawNineSliceRoundedRect
+ * \details
+ * same as QPainter::drawRoundedRect() with painter's current pen and brush,
+ * but painted with drawNineSlice() for solid pens and brushes.
+ */
+void drawNineSliceRoundedRect(QPainter *painter, const QRectF &rect, qreal xRadius, qreal yRadius)
+{
+    const QPen pen = painter->pen();
+    const QBrush brush = painter->brush();
+    // the key only has the pen's color, a gradient or texture pen is painted directly.
+    if ((pen.style() != Qt::NoPen && (pen.style() != Qt::SolidLine || pen.brush().style() != Qt::SolidPattern))
+            || (brush.style() != Qt::NoBrush && brush.style() != Qt::SolidPattern)) {
+        painter->drawRoundedRect(rect, xRadius, yRadius);
+        return;
+    }
+    if (pen.style() == Qt::NoPen && brush.style() == Qt::NoBrush)
+        return;
+
+    const qreal penWidth = pen.style() == Qt::NoPen? 0: qMax<qreal>(pen.widthF(), 1);
+    const int margin = qCeil(penWidth / 2) + 1;
+    const QRect footprint = rect.adjusted(-margin, -margin, margin, margin).toAlignedRect();
+
+    // insets of the rect in its footprint, keep the sub pixel position of edges.
+    const qreal left = rect.left() - footprint.x();
+    const qreal top = rect.top() - footprint.y();
+    const qreal right = footprint.x() + footprint.width() - rect.right();
+    const qreal bottom = footprint.y() + footprint.height() - rect.bottom();
+    const int corner = qCeil(qMax(qMax(left, right), qMax(top, bottom)) + qMax(xRadius, yRadius) + penWidth / 2) + 1;
+
+    if (!canDrawNineSlice(painter, footprint, corner)) {
+        painter->drawRoundedRect(rect, xRadius, yRadius);
+        return;
+    }
+
+    RoundedRectSprite sprite;
+    sprite.penWidth = penWidth;
+    sprite.xRadius = xRadius;
+    sprite.yRadius = yRadius;
+    sprite.left = left;
+    sprite.top = top;
+    sprite.right = right;
+    sprite.bottom = bottom;
+    sprite.brushColor = brush.style() == Qt::NoBrush? 0: brush.color().rgba();
+    sprite.penColor = pen.style() == Qt::NoPen? 0: pen.color().rgba();
+    sprite.capJoinStyle = int(pen.capStyle()) | int(pen.joinStyle());
+    sprite.corner = corner;
+    sprite.ratio = qRound(painter->device()->devicePixelRatioF());
+    sprite.antialiasing = painter->testRenderHint(QPainter::Antialiasing);
+
+    // rounded rects are painted the most, look their key up without building a string.
+    static QHash<RoundedRectSprite, QString> keys;
+    auto it = keys.constFind(sprite);
+    if (it == keys.constEnd()) {
+        if (keys.size() >= NINE_SLICE_KEY_CACHE_SIZE)
+            keys.clear();
+        const QByteArray bytes = QByteArray::fromRawData(reinterpret_cast<const char *>(&sprite), sizeof(sprite));
+        it = keys.insert(sprite, QLatin1String("ukui_nine_slice_rr_") + QString::fromLatin1(bytes.toHex()));
+    }
+
+    blitNineSlice(painter, footprint, corner, it.value(), [=](QPainter *p, const QRect &f) {
+        p->setPen(pen);
+        p->setBrush(brush);
+        p->drawRoundedRect(QRectF(f).adjusted(left, top, -right, -bottom), xRadius, yRadius);
+    });
+}
+
+/*!
+ * \brief drawCachedIndicator
+ * \param painter
+ * \param rect where the indicator is painted.
+ * \param key identifies the indicator, its state and all of its colors.
+ * \param paintIndicator paints the indicator into a rect with the same size at origin.
+ * \details
+ * Fixed size glyphs like check boxes, radio buttons and arrows are painted
+ * once per state, size and device pixel ratio, then blitted from
+ * QPixmapCache. Views with thousands of check boxes or branch arrows only
+ * hit a handful of entries.
+ *
+ * Indicators painted only from their key are persistent, they are also kept
+ * in DiskImageCache for the next processes. Indicators painted from theme
+ * icons are not, an icon theme can change without changing its name.
+ */
+void drawCachedIndicator(QPainter *painter, const QRect &rect, const QString &key,
+                         const std::function<void(QPainter *, const QRect &)> &paintIndicator, bool persistent)
+{
+    if (rect.isEmpty())
+        return;
+
+    const QRect indicatorRect(QPoint(0, 0), rect.size());
+    if (!canBlitSprite(painter)) {
+        painter->save();
+        painter->translate(rect.topLeft());
+        paintIndicator(painter, indicatorRect);
+        painter->restore();
+        return;
+    }
+
+    const int d = qRound(painter->device()->devicePixelRatioF());
+    QPixmap indicator;
+    // painted with the caller's render hints, which decide the edges.
+    const QString indicatorKey = QString("ukui_indicator_%1_%2x%3_%4").arg(key).arg(rect.width()).arg(rect.height()).arg(d)
+            + (painter->testRenderHint(QPainter::Antialiasing)? "_aa": "");
+    const bool indicatorCached = QPixmapCache::find(indicatorKey, &indicator);
+    PaintStatistics::countCache(PaintStatistics::IndicatorCacheHits, indicatorCached);
+    if (!indicatorCached) {
+        QImage image;
+        if (persistent && DiskImageCache::globalInstance()->find(indicatorKey, &image)) {
+            indicator = QPixmap::fromImage(image);
+        } else {
+            indicator = QPixmap(rect.size() * d);
+            indicator.setDevicePixelRatio(d);
+            indicator.fill(Qt::transparent);
+            QPainter p(&indicator);
+            p.setRenderHints(painter->renderHints());
+            paintIndicator(&p, indicatorRect);
+            p.end();
+            if (persistent)
+                DiskImageCache::globalInstance()->insert(indicatorKey, indicator.toImage());
+        }
+        QPixmapCache::insert(indicatorKey, indicator);
+    }
+
+    painter->drawPixmap(rect.topLeft(), indicator);
+}
+
+/*!
+ * \brief paletteKey
+ * \details
+ * a key of all colors of the palette. Unlike QPalette::cacheKey() it is the
+ * same in every process, for keys of assets kept in DiskImageCache.
+ */
+QString paletteKey(const QPalette &palette)
+{
+    static QHash<qint64, QString> keys;
+    auto it = keys.constFind(palette.cacheKey());
+    if (it != keys.constEnd())
+        return it.value();
+
+    if (keys.size() >= PALETTE_KEY_CACHE_SIZE)
+        keys.clear();
+
+    QCryptographicHash hash(QCryptographicHash::Md5);
+    for (auto group : {QPalette::Active, QPalette::Disabled, QPalette::Inactive}) {
+        for (int role = 0; role < QPalette::NColorRoles; role++) {
+            const QRgb rgba = palette.color(group, QPalette::ColorRole(role)).rgba();
+            hash.addData(reinterpret_cast<const char *>(&rgba), sizeof(rgba));
+        }
+    }
+    const QString key = QString::fromLatin1(hash.result().toHex());
+    keys.insert(palette.cacheKey(), key);
+    return key;
+}
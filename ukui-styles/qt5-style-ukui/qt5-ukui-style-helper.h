@@ -26,6 +26,7 @@
 #include "qt5-ukui-style.h"
 #include<QStyleOption>
 #include <qmath.h>
+#include <functional>
 
 void drawComboxPrimitive(const QStyleOption *option, QPainter *painter, const QWidget *widget);
 void drawMenuPrimitive(const QStyleOption *option, QPainter *painter, const QWidget *widget);
@@ -37,4 +38,11 @@ QColor mixColor(const QColor &c1, const QColor &c2, qreal bias = 0.5);
 QColor highLight_Click();
 QColor highLight_Hover();
 void drawArrow(const QStyle *style, const QStyleOptionToolButton *toolbutton, const QRect &rect, QPainter *painter, const QWidget *widget = 0);
+void drawNineSlice(QPainter *painter, const QRect &footprint, int corner, const QString &key,
+                   const std::function<void(QPainter *, const QRect &)> &paintShape);
+void drawNineSliceRoundedRect(QPainter *painter, const QRectF &rect, qreal xRadius, qreal yRadius);
+void drawCachedIndicator(QPainter *painter, const QRect &rect, const QString &key,
+                         const std::function<void(QPainter *, const QRect &)> &paintIndicator,
+                         bool persistent = false);
+QString paletteKey(const QPalette &palette);
 #endif // QT5UKUISTYLEHELPER_H
@@ -26,6 +26,7 @@
 #include "black-list.h"
 #include "ukui-style-settings.h"
 #include "highlight-effect.h"
+#include "theme-change-transaction.h"
 
 #include <QApplication>
 #include <QTimer>
@@ -46,12 +47,15 @@ Qt5UKUIStylePlugin::Qt5UKUIStylePlugin(QObject *parent) :
 
         connect(settings, &QGSettings::changed, this, [=](const QString &key){
             if (key == "iconThemeName") {
-                QString inconTheme = settings->get("iconThemeName").toString();
-                if (inconTheme == "ukui-icon-theme-classical" || inconTheme == "ukui-classical") {
-                    HighLightEffect::setSymoblicColor(QColor(128, 128, 128, 255));
-                } else {
-                    HighLightEffect::setSymoblicColor(QColor(31, 32, 34, 192));
-                }
+                ThemeChangeTransaction::schedule(ThemeChangeTransaction::IconTheme, key, this, [=]() {
+                    QString inconTheme = settings->get("iconThemeName").toString();
+                    if (inconTheme == "ukui-icon-theme-classical" || inconTheme == "ukui-classical") {
+                        HighLightEffect::setSymoblicColor(QColor(128, 128, 128, 255));
+                    } else {
+                        HighLightEffect::setSymoblicColor(QColor(31, 32, 34, 192));
+                    }
+                });
+                ThemeChangeTransaction::requestRepaint();
             }
         });
     }
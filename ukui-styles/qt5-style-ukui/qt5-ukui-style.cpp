@@ -25,6 +25,9 @@
 #include "qt5-ukui-style-helper.h"
 
 #include "ukui-style-settings.h"
+#include "ukui-palette.h"
+#include "theme-bundle.h"
+#include "black-list.h"
 #include "ukui-tabwidget-default-slide-animator.h"
 
 #include <QStyleOption>
@@ -40,10 +43,14 @@
 #include "button-animator.h"
 #include "box-animation-helper.h"
 #include "animator-iface.h"
+#include "animation-quality-governor.h"
 #include "animation-helper.h"
 #include "progressbar-animation-helper.h"
 #include "progressbar-animation.h"
 #include "shadow-helper.h"
+#include "sub-rect-memo.h"
+#include "paint-recorder.h"
+#include "paint-statistics.h"
 
 #include "highlight-effect.h"
 
@@ -66,6 +73,7 @@
 #include <QTreeWidget>
 #include <QListWidget>
 #include <QHeaderView>
+#include <QTimer>
 #include <QEvent>
 #include <QDebug>
 #include <QPixmapCache>
@@ -83,13 +91,19 @@
 #include <QDBusConnection>
 #include <QDBusReply>
 
+#include <KWindowSystem>
+
 #define DBUS_STATUS_MANAGER_IF "com.kylin.statusmanager.interface"
 
 #define COMMERCIAL_VERSION true
+#define ELIDED_TEXT_CACHE_SIZE 4096
 extern void qt_blurImage(QImage &blurImage, qreal radius, bool quality, int transposed);
 
 //---copy from qcommonstyle
 #include <QTextLayout>
+#include <QGlyphRun>
+#include <QCache>
+#include <QThread>
 
 #include <private/qtextengine_p.h>
 
@@ -200,6 +214,86 @@ QString calculateElidedText(const QString &text, const QTextOption &textOption,
     return ret;
 }
 
+/*!
+ * \brief The ElidedTextKey struct
+ * \details
+ * everything an elided text layout depends on. Only the size of the text rect
+ * is keyed, the layout is stored relative to the rect.
+ */
+struct ElidedTextKey
+{
+    QString text;
+    QFont font;
+    QSize size;
+    int wrapMode;
+    int alignment;
+    int direction;
+    int valign;
+    int elideMode;
+    int flags;
+    bool viewItem;
+};
+
+static bool operator==(const ElidedTextKey &a, const ElidedTextKey &b)
+{
+    return a.size == b.size && a.wrapMode == b.wrapMode && a.alignment == b.alignment
+            && a.direction == b.direction && a.valign == b.valign && a.elideMode == b.elideMode
+            && a.flags == b.flags && a.viewItem == b.viewItem && a.text == b.text && a.font == b.font;
+}
+
+static uint qHash(const ElidedTextKey &key, uint seed = 0)
+{
+    return qHash(key.text, seed) ^ qHash(key.font, seed) ^ qHash(key.size.width(), seed)
+            ^ (qHash(key.size.height(), seed) << 1) ^ qHash((key.wrapMode << 24) | (key.alignment << 8)
+                                                            | (key.direction << 6) | (key.elideMode << 4)
+                                                            | (key.flags << 2) | int(key.viewItem), seed)
+            ^ qHash(key.valign, seed);
+}
+
+/*!
+ * \brief The ElidedTextLayout struct
+ * \details
+ * the elided text, and for view items its laid out glyph runs and where they
+ * are painted from, relative to the text rect.
+ */
+struct ElidedTextLayout
+{
+    QString text;
+    QPointF position;
+    QList<QGlyphRun> glyphRuns;
+};
+
+static QCache<ElidedTextKey, ElidedTextLayout> *elided_text_cache = nullptr;
+
+/*!
+ * \brief elidedTextCache
+ * \details
+ * item views repaint every visible cell when they scroll or hover changes,
+ * but the text of most cells is not changed. Set qApp property
+ * "disableStyleTextCache" to lay out every paint.
+ *
+ * The cache is only used in the gui thread. It is never destroyed, its
+ * fonts and glyph runs are released on QCoreApplication::aboutToQuit(),
+ * while the font engines still exist.
+ */
+static QCache<ElidedTextKey, ElidedTextLayout> *elidedTextCache()
+{
+    if (!qApp || QThread::currentThread() != qApp->thread())
+        return nullptr;
+
+    if (!elided_text_cache) {
+        elided_text_cache = new QCache<ElidedTextKey, ElidedTextLayout>(ELIDED_TEXT_CACHE_SIZE);
+        QObject::connect(qApp, &QCoreApplication::aboutToQuit, []() {
+            elided_text_cache->clear();
+        });
+    }
+    if (qApp->property("disableStyleTextCache").toBool()) {
+        elided_text_cache->clear();
+        return nullptr;
+    }
+    return elided_text_cache;
+}
+
 QString toolButtonElideText(const QStyleOptionToolButton *option,
                             const QRect &textRect, int flags)
 {
@@ -207,16 +301,29 @@ QString toolButtonElideText(const QStyleOptionToolButton *option,
     if (option->fontMetrics.width(option->text, -1) <= textRect.width())
         return option->text;
 
+    auto cache = elidedTextCache();
+    const ElidedTextKey key = {option->text, option->font, textRect.size(), QTextOption::ManualWrap, 0,
+                               option->direction, Qt::AlignTop, Qt::ElideMiddle, flags, false};
+    if (cache) {
+        auto layout = cache->object(key);
+        PaintStatistics::countCache(PaintStatistics::TextLayoutCacheHits, layout != nullptr);
+        if (layout)
+            return layout->text;
+    }
+
     QString text = option->text;
     text.replace('\n', QChar::LineSeparator);
     QTextOption textOption;
     textOption.setWrapMode(QTextOption::ManualWrap);
     textOption.setTextDirection(option->direction);
 
-    return calculateElidedText(text, textOption,
-                               option->font, textRect, Qt::AlignTop,
-                               Qt::ElideMiddle, flags,
-                               false, nullptr);
+    const QString elidedText = calculateElidedText(text, textOption,
+                                                   option->font, textRect, Qt::AlignTop,
+                                                   Qt::ElideMiddle, flags,
+                                                   false, nullptr);
+    if (cache)
+        cache->insert(key, new ElidedTextLayout{elidedText, QPointF(), QList<QGlyphRun>()});
+    return elidedText;
 }
 
 static QWindow *qt_getWindow(const QWidget *widget)
@@ -238,6 +345,21 @@ void Qt5UKUIStyle::viewItemDrawText(QPainter *p, const QStyleOptionViewItem *opt
     textOption.setTextDirection(option->direction);
     textOption.setAlignment(QStyle::visualAlignment(option->direction, option->displayAlignment));
 
+    auto cache = elidedTextCache();
+    const ElidedTextKey key = {option->text, option->font, textRect.size(), textOption.wrapMode(),
+                               int(textOption.alignment()), option->direction, int(option->displayAlignment),
+                               option->textElideMode, 0, true};
+    if (cache) {
+        auto layout = cache->object(key);
+        PaintStatistics::countCache(PaintStatistics::TextLayoutCacheHits, layout != nullptr);
+        if (layout) {
+            const QPointF paintPosition = layout->position + textRect.topLeft();
+            for (const auto &glyphRun : layout->glyphRuns)
+                p->drawGlyphRun(paintPosition, glyphRun);
+            return;
+        }
+    }
+
     QPointF paintPosition;
     const QString newText = calculateElidedText(option->text, textOption,
                                                 option->font, textRect, option->displayAlignment,
@@ -248,6 +370,9 @@ void Qt5UKUIStyle::viewItemDrawText(QPainter *p, const QStyleOptionViewItem *opt
     textLayout.setTextOption(textOption);
     viewItemTextLayout(textLayout, textRect.width());
     textLayout.draw(p, paintPosition);
+
+    if (cache)
+        cache->insert(key, new ElidedTextLayout{newText, paintPosition - textRect.topLeft(), textLayout.glyphRuns()});
 }
 //---copy from qcommonstyle
 
@@ -266,6 +391,25 @@ Qt5UKUIStyle::Qt5UKUIStyle(bool dark, bool useDefault) : QProxyStyle("fusion")
     m_animation_helper = new ProgressBarAnimationHelper(this);
     m_shadow_helper = new ShadowHelper(this);
 
+    if (UKUIStyleSettings::isSchemaInstalled("org.ukui.style")) {
+        // the platform theme writes the bundle, the style only reads it.
+        auto bundle = ThemeBundle::globalInstance();
+        if (bundle->isValid()) {
+            m_low_end_mode = bundle->setting("lowEndMode").toBool();
+            m_paint_recording = bundle->setting("paintRecording").toBool();
+            QTimer::singleShot(THEME_BUNDLE_WATCH_DELAY, this, &Qt5UKUIStyle::watchSettings);
+        } else {
+            watchSettings();
+        }
+    }
+
+    m_compositing = KWindowSystem::compositingActive();
+    connect(KWindowSystem::self(), &KWindowSystem::compositingChanged, this, &Qt5UKUIStyle::updateCompositing);
+    m_shadow_helper->setShadowEnabled(!useOpaqueSurfaces());
+
+    PaintStatistics::globalInstance()->exportOnSessionBus("style");
+    AnimationQualityGovernor::globalInstance()->exportOnSessionBus("style");
+
     //dbus
     m_statusManagerDBus = new QDBusInterface(DBUS_STATUS_MANAGER_IF, "/" ,DBUS_STATUS_MANAGER_IF,QDBusConnection::sessionBus(),this);
     if (m_statusManagerDBus) {
@@ -284,25 +428,12 @@ Qt5UKUIStyle::Qt5UKUIStyle(bool dark, bool useDefault) : QProxyStyle("fusion")
 const QStringList Qt5UKUIStyle::specialList() const
 {
     //use dark palette in default style.
-    QStringList l;
-    l<<"ukui-menu";
-    l<<"ukui-panel";
-    l<<"ukui-sidebar";
-    l<<"ukui-volume-control-applet-qt";
-    l<<"ukui-power-manager-tray";
-    l<<"kylin-nm";
-    l<<"ukui-flash-disk";
-//    l<<"ukui-bluetooth";
-    l<<"mktip";
-    return l;
+    return darkPaletteAppList();
 }
 
 const QStringList Qt5UKUIStyle::useDefaultPalette() const
 {
-    QStringList l;
-    l<<"kybackup";
-    l<<"biometric-manager";
-    return l;
+    return defaultPaletteAppList();
 }
 
 bool Qt5UKUIStyle::shouldBeTransparent(const QWidget *w) const
@@ -336,6 +467,28 @@ bool Qt5UKUIStyle::eventFilter(QObject *obj, QEvent *e)
         return true;
     }
 
+    if (e->type() == QEvent::WinIdChange) {
+        // the window type of a menu is set on its native window, once it is created.
+        realSetMenuTypeToMenu(qobject_cast<QWidget *>(obj));
+        return false;
+    }
+
+    if (e->type() == QEvent::ChildAdded && qobject_cast<QComboBox *>(obj)) {
+        /*!
+          the popup container of a combo box is created and its native window
+          is created right before it is shown, it is only polished after that.
+          When it is added to the combo box it is still being constructed, but
+          it is already a popup window, that is the last chance to choose an
+          alpha surface.
+          */
+        auto child = static_cast<QChildEvent *>(e)->child();
+        if (child->isWidgetType() && static_cast<QWidget *>(child)->windowType() == Qt::Popup
+                && !static_cast<QWidget *>(child)->testAttribute(Qt::WA_WState_Created) && !useOpaqueSurfaces()) {
+            static_cast<QWidget *>(child)->setAttribute(Qt::WA_TranslucentBackground);
+        }
+        return false;
+    }
+
     if (qobject_cast<QPushButton *>(obj) || qobject_cast<QToolButton *>(obj)) {
         if (e->type() == QEvent::Hide) {
             if (QWidget *w = qobject_cast<QWidget *>(obj)) {
@@ -353,19 +506,8 @@ bool Qt5UKUIStyle::eventFilter(QObject *obj, QEvent *e)
     return false;
 }
 
-/*
- * Note there are some widgets can not be set as transparent one in polish.
- * Because it has been created as a rgb window.
- *
- * To reslove this problem, we have to let attribute be setted more ahead.
- * Some styleHint() methods are called in the early creation of a widget.
- * So we can real set them as alpha widgets.
- */
 int Qt5UKUIStyle::styleHint(QStyle::StyleHint hint, const QStyleOption *option, const QWidget *widget, QStyleHintReturn *returnData) const
 {
-    realSetWindowSurfaceFormatAlpha(widget);
-    realSetMenuTypeToMenu(widget);
-
     switch (hint) {
     case SH_ScrollBar_Transient:
         return false;
@@ -406,100 +548,16 @@ void Qt5UKUIStyle::polish(QPalette &palette){
 
 QPalette Qt5UKUIStyle::standardPalette() const
 {
-    auto palette = Style::standardPalette();
-    //ukui-light
-    QColor  window_bg(245 , 245, 245),
-            window_no_bg(237 ,237, 237),
-            base_bg(255, 255, 255),
-            base_no_bg(245, 245, 245),
-            font_bg(0,0,0),
-            font_br_bg(255,255,255),
-            font_di_bg(0, 0, 0, 76),
-            button_bg(230, 230, 230),
-            button_di_bg(233,233,233),
-            highlight_bg(55,144,250),
-            highlight_dis(233, 233, 233),
-            tip_bg(248,248,248),
-            tip_font(22,22,22),
-            alternateBase(248,248,248),
-            midlight_bg(217, 217, 217),
-            midlight_dis(230, 230, 230);
-
-        if (!useDefaultPalette().contains(qAppName()) && (qApp->property("preferDark").toBool() || (m_is_default_style && specialList().contains(qAppName())))) {
-        //ukui-dark
-        window_bg.setRgb(31, 32, 34);
-        window_no_bg.setRgb(26 , 26, 26);
-        base_bg.setRgb(18, 18, 18);
-        base_no_bg.setRgb(28, 28, 28);
-        font_bg.setRgb(255,255,255);
-        font_bg.setAlphaF(0.9);
-        font_br_bg.setRgb(255,255,255);
-        font_br_bg.setAlphaF(0.9);
-        font_di_bg.setRgb(255,255,255);
-        font_di_bg.setAlphaF(0.3);
-        button_bg.setRgb(51, 51, 54);
-        button_di_bg.setRgb(46, 46, 48);
-        highlight_dis.setRgb(71, 71, 71);
-        tip_bg.setRgb(61,61,65);
-        tip_font.setRgb(232,232,232);
-        alternateBase.setRgb(36,35,40);
-        midlight_bg.setRgb(77, 77, 77);
-        midlight_dis.setRgb(64, 64, 64);
-        }
-
-    palette.setBrush(QPalette::Active, QPalette::Window, window_bg);
-    palette.setBrush(QPalette::Inactive, QPalette::Window, window_bg);
-    palette.setBrush(QPalette::Disabled, QPalette::Window, window_no_bg);
-
-    palette.setBrush(QPalette::WindowText,font_bg);
-    palette.setBrush(QPalette::Active,QPalette::WindowText,font_bg);
-    palette.setBrush(QPalette::Inactive,QPalette::WindowText,font_bg);
-    palette.setBrush(QPalette::Disabled,QPalette::WindowText,font_di_bg);
-
-    palette.setBrush(QPalette::Active, QPalette::Base, base_bg);
-    palette.setBrush(QPalette::Inactive, QPalette::Base, base_bg);
-    palette.setBrush(QPalette::Disabled, QPalette::Base, base_no_bg);
-
-    palette.setBrush(QPalette::Text,font_bg);
-    palette.setBrush(QPalette::Active,QPalette::Text,font_bg);
-    palette.setBrush(QPalette::Disabled,QPalette::Text,font_di_bg);
-
-    //Cursor placeholder
-#if (QT_VERSION >= QT_VERSION_CHECK(5,12,0))
-    palette.setBrush(QPalette::PlaceholderText,font_di_bg);
-#endif
-
-    palette.setBrush(QPalette::ToolTipBase,tip_bg);
-    palette.setBrush(QPalette::ToolTipText,tip_font);
+    const bool dark = !useDefaultPalette().contains(qAppName()) && (qApp->property("preferDark").toBool() || (m_is_default_style && specialList().contains(qAppName())));
 
-    palette.setBrush(QPalette::Active, QPalette::Highlight, highlight_bg);
-    palette.setBrush(QPalette::Inactive, QPalette::Highlight, highlight_bg);
-    palette.setBrush(QPalette::Disabled, QPalette::Highlight, highlight_dis);
-
-    palette.setBrush(QPalette::HighlightedText,font_br_bg);
-
-    palette.setBrush(QPalette::BrightText,font_br_bg);
-    palette.setBrush(QPalette::Active,QPalette::BrightText,font_br_bg);
-    palette.setBrush(QPalette::Inactive,QPalette::BrightText,font_br_bg);
-    palette.setBrush(QPalette::Disabled,QPalette::BrightText,font_di_bg);
-
-    palette.setBrush(QPalette::Active, QPalette::Button, button_bg);
-    palette.setBrush(QPalette::Inactive, QPalette::Button, button_bg);
-    palette.setBrush(QPalette::Disabled, QPalette::Button, button_di_bg);
-
-    palette.setBrush(QPalette::ButtonText,font_bg);
-    palette.setBrush(QPalette::Inactive,QPalette::ButtonText,font_bg);
-    palette.setBrush(QPalette::Disabled,QPalette::ButtonText,font_di_bg);
-
-    palette.setBrush(QPalette::AlternateBase,alternateBase);
-    palette.setBrush(QPalette::Inactive,QPalette::AlternateBase,alternateBase);
-    palette.setBrush(QPalette::Disabled,QPalette::AlternateBase,button_di_bg);
-
-    palette.setBrush(QPalette::Active, QPalette::Midlight, midlight_bg);
-    palette.setBrush(QPalette::Inactive, QPalette::Midlight, midlight_bg);
-    palette.setBrush(QPalette::Disabled, QPalette::Midlight, midlight_dis);
+    auto bundle = ThemeBundle::globalInstance();
+    if (bundle->isValid()) {
+        auto palette = bundle->value(dark? THEME_BUNDLE_DARK_PALETTE: THEME_BUNDLE_LIGHT_PALETTE);
+        if (palette.canConvert<QPalette>())
+            return qvariant_cast<QPalette>(palette);
+    }
 
-    return palette;
+    return ukuiStandardPalette(dark, Style::standardPalette());
 }
 
 
@@ -535,21 +593,118 @@ QColor Qt5UKUIStyle::button_DisableChecked() const
     }
 }
 
+/*!
+ * \brief Qt5UKUIStyle::updateTabletModeValue
+ * \details
+ * only the widgets depending on the tablet mode are told about the switch,
+ * with the QEvent::StyleChange QApplication::setStyle() would send them, so
+ * that they query their hints and metrics again and relayout. The palette
+ * does not change with the tablet mode.
+ */
 void Qt5UKUIStyle::updateTabletModeValue(bool isTabletMode)
 {
+    if (m_is_tablet_mode == isTabletMode)
+        return;
+
     m_is_tablet_mode = isTabletMode;
 
-    qApp->setPalette(qGuiApp->palette());
-    QEvent event(QEvent::ApplicationPaletteChange);
-    foreach (QWidget *widget, qApp->allWidgets()) {
+    for (auto widget : qApp->allWidgets()) {
+        if (!isTabletModeSensitive(widget))
+            continue;
+        QEvent event(QEvent::StyleChange);
         qApp->sendEvent(widget, &event);
     }
 }
 
+bool Qt5UKUIStyle::isTabletModeSensitive(const QWidget *widget) const
+{
+    if (widget->property("tabletModeAware").toBool())
+        return true;
+
+    return qobject_cast<const QAbstractItemView *>(widget);
+}
+
+/*!
+ * \brief Qt5UKUIStyle::watchSettings
+ * \details
+ * reads the settings of the style and follows their changes. A style created
+ * from a valid theme bundle calls this after startup.
+ */
+void Qt5UKUIStyle::watchSettings()
+{
+    auto settings = UKUIStyleSettings::globalInstance();
+    auto bundle = ThemeBundle::globalInstance();
+    if (settings->keys().contains("lowEndMode")) {
+        updateLowEndMode(settings->get("lowEndMode").toBool());
+        connect(settings, &QGSettings::changed, this, [=](const QString &key) {
+            if (key == "lowEndMode")
+                updateLowEndMode(settings->get(key).toBool());
+        });
+    }
+    if (settings->keys().contains("paintRecording")) {
+        m_paint_recording = settings->get("paintRecording").toBool();
+        connect(settings, &QGSettings::changed, this, [=](const QString &key) {
+            if (key == "paintRecording")
+                m_paint_recording = settings->get(key).toBool();
+        });
+    }
+
+    connect(settings, &QGSettings::changed, this, [=]() {
+        bundle->invalidate();
+    });
+}
+
+void Qt5UKUIStyle::updateLowEndMode(bool lowEndMode)
+{
+    if (m_low_end_mode == lowEndMode)
+        return;
+
+    m_low_end_mode = lowEndMode;
+    updateSurfaceMode();
+}
+
+void Qt5UKUIStyle::updateCompositing(bool active)
+{
+    if (m_compositing == active)
+        return;
+
+    m_compositing = active;
+    updateSurfaceMode();
+}
+
+void Qt5UKUIStyle::updateSurfaceMode()
+{
+    m_shadow_helper->setShadowEnabled(!useOpaqueSurfaces());
+
+    // menus and tooltips created from now on use the new surface format,
+    // existing ones keep their surface, see shouldPaintOpaqueFrame().
+    for (auto widget : qApp->allWidgets()) {
+        widget->update();
+    }
+}
+
+bool Qt5UKUIStyle::useOpaqueSurfaces() const
+{
+    return m_low_end_mode || !m_compositing;
+}
+
+bool Qt5UKUIStyle::shouldPaintOpaqueFrame(const QWidget *widget) const
+{
+    if (useOpaqueSurfaces())
+        return true;
+
+    // an rgb popup created while there was no compositor.
+    return widget && widget->isWindow() && !widget->testAttribute(Qt::WA_TranslucentBackground);
+}
+
 void Qt5UKUIStyle::polish(QWidget *widget)
 {
     Style::polish(widget);
 
+    // menus and tooltips are polished before their native windows are created.
+    realSetWindowSurfaceFormatAlpha(widget);
+    realSetMenuTypeToMenu(widget);
+
     m_shadow_helper->registerWidget(widget);
 
     if (qobject_cast<QTabWidget*>(widget)) {
@@ -584,6 +739,13 @@ void Qt5UKUIStyle::polish(QWidget *widget)
     {
         m_combobox_animation_helper->registerWidget(widget);
         m_button_animation_helper->registerWidget(widget);
+
+        // view(), setView() and setItemDelegate() create the popup container
+        // before the combo box is polished, see eventFilter() for later ones.
+        for (auto child : widget->findChildren<QWidget *>(QString(), Qt::FindDirectChildrenOnly)) {
+            if (child->inherits("QComboBoxPrivateContainer"))
+                realSetWindowSurfaceFormatAlpha(child);
+        }
     }
 
     if(qobject_cast<QSpinBox*>(widget) || qobject_cast<QDoubleSpinBox*>(widget))
@@ -681,6 +843,36 @@ QIcon Qt5UKUIStyle::standardIcon(StandardPixmap standardIcon, const QStyleOption
 
 
 
+/*!
+ * \brief iconEffectKey
+ * \details
+ * everything HighLightEffect reads to tint a symbolic icon, used to key
+ * cached indicators painted from theme icons. The palette is keyed by the
+ * colors read, palettes modified for every paint get a new cacheKey().
+ */
+static QString iconEffectKey(const QStyleOption *option, const QWidget *widget)
+{
+    const QStyle::State state = option->state & (QStyle::State_Enabled | QStyle::State_MouseOver | QStyle::State_Sunken
+                                                 | QStyle::State_On | QStyle::State_Selected);
+    QString key = QString("%1_%2_%3_%4_%5_%6_%7").arg(int(state)).arg(QIcon::themeName())
+            .arg(option->palette.text().color().rgba()).arg(option->palette.highlightedText().color().rgba())
+            .arg(option->palette.color(QPalette::Active, QPalette::Text).rgba())
+            .arg(qApp->palette().windowText().color().rgba())
+            .arg(qobject_cast<const QAbstractItemView *>(widget) != nullptr);
+    if (widget) {
+        for (auto property : {"setIconHighlightEffectDefaultColor", "setIconHighlightEffectHoverColor", "iconHighlightEffectMode"}) {
+            const QVariant value = widget->property(property);
+            if (!value.isValid())
+                key.append("_");
+            else if (value.canConvert<QColor>())
+                key.append(QString("_%1").arg(value.value<QColor>().rgba()));
+            else
+                key.append(QString("_%1").arg(value.toInt()));
+        }
+    }
+    return key;
+}
+
 static inline uint qt_intensity(uint r, uint g, uint b)
 {
     // 30% red, 59% green, 11% blue
@@ -753,6 +945,8 @@ QPixmap Qt5UKUIStyle::generatedIconPixmap(QIcon::Mode iconMode, const QPixmap &p
 
 void Qt5UKUIStyle::drawPrimitive(QStyle::PrimitiveElement element, const QStyleOption *option, QPainter *painter, const QWidget *widget) const
 {
+    PaintStatistics::ElementTimer elementTimer(PaintStatistics::Primitive, element);
+
     switch (element) {
     case QStyle::PE_PanelMenu:
     {
@@ -768,6 +962,14 @@ void Qt5UKUIStyle::drawPrimitive(QStyle::PrimitiveElement element, const QStyleO
     }
     case QStyle::PE_FrameMenu:
     {
+        if (shouldPaintOpaqueFrame(widget)) {
+            painter->save();
+            painter->setPen(option->palette.color(QPalette::Dark));
+            painter->setBrush(option->palette.brush(QPalette::Base));
+            painter->drawRect(option->rect.adjusted(0, 0, -1, -1));
+            painter->restore();
+            return;
+        }
         return drawMenuPrimitive(option, painter, widget);
     }
     case PE_FrameFocusRect: {
@@ -941,7 +1143,7 @@ void Qt5UKUIStyle::drawPrimitive(QStyle::PrimitiveElement element, const QStyleO
                 else
                     painter->setBrush(option->palette.brush(QPalette::Disabled, QPalette::Button));
                 painter->setRenderHint(QPainter::Antialiasing, true);
-                painter->drawRoundedRect(option->rect, x_Radius, y_Radius);
+                drawNineSliceRoundedRect(painter, option->rect, x_Radius, y_Radius);
                 painter->restore();
                 return;
             }
@@ -954,7 +1156,7 @@ void Qt5UKUIStyle::drawPrimitive(QStyle::PrimitiveElement element, const QStyleO
                 else
                     painter->setBrush(option->palette.brush(QPalette::Active, QPalette::Button));
                 painter->setRenderHint(QPainter::Antialiasing, true);
-                painter->drawRoundedRect(option->rect, x_Radius, y_Radius);
+                drawNineSliceRoundedRect(painter, option->rect, x_Radius, y_Radius);
                 painter->restore();
             }
 
@@ -993,7 +1195,7 @@ void Qt5UKUIStyle::drawPrimitive(QStyle::PrimitiveElement element, const QStyleO
                             painter->setBrush(highLight_Hover());
                     }
                 }
-                painter->drawRoundedRect(button->rect, x_Radius, y_Radius);
+                drawNineSliceRoundedRect(painter, button->rect, x_Radius, y_Radius);
                 painter->restore();
                 return;
             }
@@ -1038,7 +1240,7 @@ void Qt5UKUIStyle::drawPrimitive(QStyle::PrimitiveElement element, const QStyleO
                 }
                 painter->setBrush(mixColor(hoverColor, sunkenColor, opacity));
                 painter->setRenderHint(QPainter::Antialiasing, true);
-                painter->drawRoundedRect(option->rect, x_Radius, y_Radius);
+                drawNineSliceRoundedRect(painter, option->rect, x_Radius, y_Radius);
                 painter->restore();
                 return;
             }
@@ -1078,7 +1280,7 @@ void Qt5UKUIStyle::drawPrimitive(QStyle::PrimitiveElement element, const QStyleO
                     else
                         painter->setBrush(highLight_Hover());
                 }
-                painter->drawRoundedRect(option->rect, x_Radius, y_Radius);
+                drawNineSliceRoundedRect(painter, option->rect, x_Radius, y_Radius);
                 painter->restore();
                 return;
             }
@@ -1089,6 +1291,14 @@ void Qt5UKUIStyle::drawPrimitive(QStyle::PrimitiveElement element, const QStyleO
 
     case PE_PanelTipLabel://UKUI Tip  style: Open ground glass
         {
+            if (widget && widget->isEnabled() && shouldPaintOpaqueFrame(widget)) {
+                painter->save();
+                painter->setPen(option->palette.toolTipBase().color().darker(150));
+                painter->setBrush(option->palette.toolTipBase());
+                painter->drawRect(option->rect.adjusted(0, 0, -1, -1));
+                painter->restore();
+                return;
+            }
             if (widget && widget->isEnabled()) {
                 QStyleOption opt = *option;
 
@@ -1224,7 +1434,7 @@ void Qt5UKUIStyle::drawPrimitive(QStyle::PrimitiveElement element, const QStyleO
             else
                 painter->setBrush(option->palette.color(QPalette::Disabled, QPalette::Button));
             painter->setRenderHint(QPainter::Antialiasing, true);
-            painter->drawRoundedRect(option->rect, 4, 4);
+            drawNineSliceRoundedRect(painter, option->rect, 4, 4);
             painter->restore();
             return;
         }
@@ -1234,7 +1444,7 @@ void Qt5UKUIStyle::drawPrimitive(QStyle::PrimitiveElement element, const QStyleO
             painter->setPen(Qt::NoPen);
             painter->setBrush(option->palette.color(QPalette::Active, QPalette::Button));
             painter->setRenderHint(QPainter::Antialiasing, true);
-            painter->drawRoundedRect(option->rect, 4, 4);
+            drawNineSliceRoundedRect(painter, option->rect, 4, 4);
             painter->restore();
         }
 
@@ -1267,7 +1477,7 @@ void Qt5UKUIStyle::drawPrimitive(QStyle::PrimitiveElement element, const QStyleO
                     painter->setBrush(highLight_Hover());
                 }
             }
-            painter->drawRoundedRect(option->rect, 4, 4);
+            drawNineSliceRoundedRect(painter, option->rect, 4, 4);
             painter->restore();
             return;
         }
@@ -1306,7 +1516,7 @@ void Qt5UKUIStyle::drawPrimitive(QStyle::PrimitiveElement element, const QStyleO
                 sunkenColor = highLight_Click();
             }
             painter->setBrush(mixColor(hoverColor, sunkenColor, opacity));
-            painter->drawRoundedRect(option->rect, 4, 4);
+            drawNineSliceRoundedRect(painter, option->rect, 4, 4);
             painter->restore();
             return;
         }
@@ -1340,7 +1550,7 @@ void Qt5UKUIStyle::drawPrimitive(QStyle::PrimitiveElement element, const QStyleO
             } else {
                 painter->setBrush(highLight_Hover());
             }
-            painter->drawRoundedRect(option->rect, 4, 4);
+            drawNineSliceRoundedRect(painter, option->rect, 4, 4);
             painter->restore();
             return;
         }
@@ -1349,27 +1559,31 @@ void Qt5UKUIStyle::drawPrimitive(QStyle::PrimitiveElement element, const QStyleO
 
     case PE_IndicatorTabClose:
     {
-        painter->save();
-        painter->setPen(Qt::NoPen);
-        painter->setRenderHint(QPainter::Antialiasing);
-        painter->setBrush(option->palette.brush(QPalette::Active, QPalette::Text));
-        if (option->state & (State_On | State_Sunken)) {
-            painter->setOpacity(0.15);
-        }
-        else if (option->state & State_MouseOver) {
-            painter->setOpacity(0.1);
-        }
-        else
-            painter->setOpacity(0.0);
-        painter->drawEllipse(option->rect);
-        painter->restore();
         QIcon icon = QIcon::fromTheme("window-close-symbolic");
-        if (!icon.isNull()) {
-            int iconSize = proxy()->pixelMetric(QStyle::PM_SmallIconSize, option, widget);
-            QPixmap pixmap = icon.pixmap(QSize(iconSize, iconSize), QIcon::Normal, QIcon::On);
-            pixmap = HighLightEffect::ordinaryGeneratePixmap(pixmap, option, widget);
-            proxy()->drawItemPixmap(painter, option->rect, Qt::AlignCenter, pixmap);
-        }
+        const QString key = QString("tabclose_%1_%2").arg(int(option->state & (State_On | State_Sunken | State_MouseOver)))
+                .arg(iconEffectKey(option, widget));
+        drawCachedIndicator(painter, option->rect, key, [&](QPainter *p, const QRect &rect) {
+            p->save();
+            p->setPen(Qt::NoPen);
+            p->setRenderHint(QPainter::Antialiasing);
+            p->setBrush(option->palette.brush(QPalette::Active, QPalette::Text));
+            if (option->state & (State_On | State_Sunken)) {
+                p->setOpacity(0.15);
+            }
+            else if (option->state & State_MouseOver) {
+                p->setOpacity(0.1);
+            }
+            else
+                p->setOpacity(0.0);
+            p->drawEllipse(rect);
+            p->restore();
+            if (!icon.isNull()) {
+                int iconSize = proxy()->pixelMetric(QStyle::PM_SmallIconSize, option, widget);
+                QPixmap pixmap = icon.pixmap(QSize(iconSize, iconSize), QIcon::Normal, QIcon::On);
+                pixmap = HighLightEffect::ordinaryGeneratePixmap(pixmap, option, widget);
+                proxy()->drawItemPixmap(p, rect, Qt::AlignCenter, pixmap);
+            }
+        });
         return;
     }
 
@@ -1443,7 +1657,7 @@ void Qt5UKUIStyle::drawPrimitive(QStyle::PrimitiveElement element, const QStyleO
                 painter->setPen(Qt::NoPen);
                 painter->setBrush(f->palette.brush(QPalette::Disabled, QPalette::Button));
                 painter->setRenderHint(QPainter::Antialiasing, true);
-                painter->drawRoundedRect(option->rect, 4, 4);
+                drawNineSliceRoundedRect(painter, option->rect, 4, 4);
                 painter->restore();
                 return;
             }
@@ -1453,7 +1667,7 @@ void Qt5UKUIStyle::drawPrimitive(QStyle::PrimitiveElement element, const QStyleO
                 painter->setPen(Qt::NoPen);
                 painter->setBrush(f->palette.brush(QPalette::Active, QPalette::Button));
                 painter->setRenderHint(QPainter::Antialiasing, true);
-                painter->drawRoundedRect(option->rect, 4, 4);
+                drawNineSliceRoundedRect(painter, option->rect, 4, 4);
                 painter->restore();
                 return;
             }
@@ -1464,7 +1678,7 @@ void Qt5UKUIStyle::drawPrimitive(QStyle::PrimitiveElement element, const QStyleO
                                      2, Qt::SolidLine, Qt::RoundCap, Qt::RoundJoin));
                 painter->setBrush(option->palette.brush(QPalette::Active, QPalette::Base));
                 painter->setRenderHint(QPainter::Antialiasing, true);
-                painter->drawRoundedRect(option->rect.adjusted(1, 1, -1, -1), 4, 4);
+                drawNineSliceRoundedRect(painter, option->rect.adjusted(1, 1, -1, -1), 4, 4);
                 painter->restore();
             } else {
                 QStyleOptionButton button;
@@ -1479,7 +1693,7 @@ void Qt5UKUIStyle::drawPrimitive(QStyle::PrimitiveElement element, const QStyleO
                                          1, Qt::SolidLine, Qt::RoundCap, Qt::RoundJoin));
                     painter->setBrush(Qt::NoBrush);
                     painter->setRenderHint(QPainter::Antialiasing, true);
-                    painter->drawRoundedRect(rect.adjusted(0.5, 0.5, -0.5, -0.5), 4, 4);
+                    drawNineSliceRoundedRect(painter, rect.adjusted(0.5, 0.5, -0.5, -0.5), 4, 4);
                     painter->restore();
                 }
             }
@@ -1489,71 +1703,27 @@ void Qt5UKUIStyle::drawPrimitive(QStyle::PrimitiveElement element, const QStyleO
     }
 
     case PE_IndicatorArrowUp:
-    {
-        QIcon icon = QIcon::fromTheme("ukui-up-symbolic");
-        if(!icon.isNull()) {
-            int indWidth = proxy()->pixelMetric(PM_IndicatorWidth, option, widget);
-            int indHight = proxy()->pixelMetric(PM_IndicatorHeight, option, widget);
-            QSize iconsize(indWidth, indHight);
-            QRect drawRect(option->rect.topLeft(), iconsize);
-            drawRect.moveCenter(option->rect.center());
-            const bool enable(option->state & State_Enabled);
-            QIcon::Mode mode =  enable ? QIcon::Normal : QIcon::Disabled;
-            QPixmap pixmap = icon.pixmap(iconsize, mode, QIcon::Off);
-            QPixmap target = HighLightEffect::bothOrdinaryAndHoverGeneratePixmap(pixmap, option, widget);
-            painter->save();
-            painter->drawPixmap(drawRect, target);
-            painter->restore();
-            return;
-        }
-        break;
-    }
-
     case PE_IndicatorArrowDown:
-    {
-        QIcon icon = QIcon::fromTheme("ukui-down-symbolic");
-        if(!icon.isNull()) {
-            int indWidth = proxy()->pixelMetric(PM_IndicatorWidth, option, widget);
-            int indHight = proxy()->pixelMetric(PM_IndicatorHeight, option, widget);
-            QSize iconsize(indWidth, indHight);
-            QRect drawRect(option->rect.topLeft(), iconsize);
-            drawRect.moveCenter(option->rect.center());
-            const bool enable(option->state & State_Enabled);
-            QIcon::Mode mode =  enable ? QIcon::Normal : QIcon::Disabled;
-            QPixmap pixmap = icon.pixmap(iconsize, mode, QIcon::Off);
-            QPixmap target = HighLightEffect::bothOrdinaryAndHoverGeneratePixmap(pixmap, option, widget);
-            painter->save();
-            painter->drawPixmap(drawRect, target);
-            painter->restore();
-            return;
-        }
-        break;
-    }
-
     case PE_IndicatorArrowRight:
+    case PE_IndicatorArrowLeft:
     {
-        QIcon icon = QIcon::fromTheme("ukui-end-symbolic");
-        if(!icon.isNull()) {
-            int indWidth = proxy()->pixelMetric(PM_IndicatorWidth, option, widget);
-            int indHight = proxy()->pixelMetric(PM_IndicatorHeight, option, widget);
-            QSize iconsize(indWidth, indHight);
-            QRect drawRect(option->rect.topLeft(), iconsize);
-            drawRect.moveCenter(option->rect.center());
-            const bool enable(option->state & State_Enabled);
-            QIcon::Mode mode =  enable ? QIcon::Normal : QIcon::Disabled;
-            QPixmap pixmap = icon.pixmap(iconsize, mode, QIcon::Off);
-            QPixmap target = HighLightEffect::bothOrdinaryAndHoverGeneratePixmap(pixmap, option, widget);
-            painter->save();
-            painter->drawPixmap(drawRect, target);
-            painter->restore();
-            return;
+        QString iconName;
+        switch (element) {
+        case PE_IndicatorArrowUp:
+            iconName = "ukui-up-symbolic";
+            break;
+        case PE_IndicatorArrowDown:
+            iconName = "ukui-down-symbolic";
+            break;
+        case PE_IndicatorArrowRight:
+            iconName = "ukui-end-symbolic";
+            break;
+        default:
+            iconName = "ukui-start-symbolic";
+            break;
         }
-        break;
-    }
 
-    case PE_IndicatorArrowLeft:
-    {
-        QIcon icon = QIcon::fromTheme("ukui-start-symbolic");
+        QIcon icon = QIcon::fromTheme(iconName);
         if(!icon.isNull()) {
             int indWidth = proxy()->pixelMetric(PM_IndicatorWidth, option, widget);
             int indHight = proxy()->pixelMetric(PM_IndicatorHeight, option, widget);
@@ -1562,11 +1732,12 @@ void Qt5UKUIStyle::drawPrimitive(QStyle::PrimitiveElement element, const QStyleO
             drawRect.moveCenter(option->rect.center());
             const bool enable(option->state & State_Enabled);
             QIcon::Mode mode =  enable ? QIcon::Normal : QIcon::Disabled;
-            QPixmap pixmap = icon.pixmap(iconsize, mode, QIcon::Off);
-            QPixmap target = HighLightEffect::bothOrdinaryAndHoverGeneratePixmap(pixmap, option, widget);
-            painter->save();
-            painter->drawPixmap(drawRect, target);
-            painter->restore();
+            const QString key = QString("%1_%2").arg(iconName).arg(iconEffectKey(option, widget));
+            drawCachedIndicator(painter, drawRect, key, [&](QPainter *p, const QRect &rect) {
+                QPixmap pixmap = icon.pixmap(iconsize, mode, QIcon::Off);
+                QPixmap target = HighLightEffect::bothOrdinaryAndHoverGeneratePixmap(pixmap, option, widget);
+                p->drawPixmap(rect, target);
+            });
             return;
         }
         break;
@@ -1575,8 +1746,6 @@ void Qt5UKUIStyle::drawPrimitive(QStyle::PrimitiveElement element, const QStyleO
     case PE_IndicatorRadioButton:
     {
         if (const QStyleOptionButton* radiobutton = qstyleoption_cast<const QStyleOptionButton*>(option)) {
-            QRectF rect = radiobutton->rect.adjusted(1, 1, -1, -1);
-
             const bool useDarkPalette = !useDefaultPalette().contains(qAppName()) && (qApp->property("preferDark").toBool()
                                                                                       || (m_is_default_style && specialList().contains(qAppName())));
             bool enable = radiobutton->state & State_Enabled;
@@ -1584,79 +1753,82 @@ void Qt5UKUIStyle::drawPrimitive(QStyle::PrimitiveElement element, const QStyleO
             bool sunKen = radiobutton->state & State_Sunken;
             bool On = radiobutton->state & State_On;
 
-            painter->save();
-            painter->setRenderHint(QPainter::Antialiasing, true);
-            if (On) {
-                if (enable) {
-                    if (sunKen) {
-                        painter->setPen(QColor(25, 101, 207));
-                        painter->setBrush(highLight_Click());
-                    } else if (mouseOver) {
-                        painter->setPen(QColor(36, 109, 212));
-                        painter->setBrush(highLight_Hover());
-                    } else {
-                        painter->setPen(QColor(36, 109, 212));
-                        painter->setBrush(radiobutton->palette.brush(QPalette::Active, QPalette::Highlight));
-                    }
-                    painter->drawEllipse(rect);
-                    QRectF childRect(rect.x(), rect.y(), 6, 6);
-                    childRect.moveCenter(rect.center());
-                    painter->setPen(Qt::NoPen);
-                    painter->setBrush(radiobutton->palette.brush(QPalette::Active, QPalette::HighlightedText));
-                    painter->drawEllipse(childRect);
-                } else {
-                    if (useDarkPalette) {
-                        painter->setPen(QColor(48, 48, 51));
-                        painter->setBrush(QColor(28, 28, 30));
+            const QString key = QString("radio_%1_%2_%3_%4_%5_%6").arg(enable).arg(mouseOver).arg(sunKen).arg(On)
+                    .arg(useDarkPalette).arg(paletteKey(radiobutton->palette));
+            drawCachedIndicator(painter, radiobutton->rect, key, [&](QPainter *p, const QRect &indicatorRect) {
+                QRectF rect = indicatorRect.adjusted(1, 1, -1, -1);
+                p->setRenderHint(QPainter::Antialiasing, true);
+                if (On) {
+                    if (enable) {
+                        if (sunKen) {
+                            p->setPen(QColor(25, 101, 207));
+                            p->setBrush(highLight_Click());
+                        } else if (mouseOver) {
+                            p->setPen(QColor(36, 109, 212));
+                            p->setBrush(highLight_Hover());
+                        } else {
+                            p->setPen(QColor(36, 109, 212));
+                            p->setBrush(radiobutton->palette.brush(QPalette::Active, QPalette::Highlight));
+                        }
+                        p->drawEllipse(rect);
+                        QRectF childRect(rect.x(), rect.y(), 6, 6);
+                        childRect.moveCenter(rect.center());
+                        p->setPen(Qt::NoPen);
+                        p->setBrush(radiobutton->palette.brush(QPalette::Active, QPalette::HighlightedText));
+                        p->drawEllipse(childRect);
                     } else {
-                        painter->setPen(QColor(224, 224, 224));
-                        painter->setBrush(QColor(233, 233, 233));
-                    }
-                    painter->drawEllipse(rect);
-                    QRectF childRect(rect.x(), rect.y(), 6, 6);
-                    childRect.moveCenter(rect.center());
-                    painter->setBrush(radiobutton->palette.brush(QPalette::Disabled, QPalette::ButtonText));
-                    painter->drawEllipse(childRect);
-                }
-            } else {
-                if (enable) {
-                    if (sunKen) {
                         if (useDarkPalette) {
-                            painter->setPen(QColor(36, 109, 212));
-                            painter->setBrush(QColor(6, 35, 97));
+                            p->setPen(QColor(48, 48, 51));
+                            p->setBrush(QColor(28, 28, 30));
                         } else {
-                            painter->setPen(QColor(36, 109, 212));
-                            painter->setBrush(QColor(179, 221, 255));
+                            p->setPen(QColor(224, 224, 224));
+                            p->setBrush(QColor(233, 233, 233));
                         }
-                    } else if (mouseOver) {
-                        if (useDarkPalette) {
-                            painter->setPen(QColor(55, 144, 250));
-                            painter->setBrush(QColor(9, 53, 153));
+                        p->drawEllipse(rect);
+                        QRectF childRect(rect.x(), rect.y(), 6, 6);
+                        childRect.moveCenter(rect.center());
+                        p->setBrush(radiobutton->palette.brush(QPalette::Disabled, QPalette::ButtonText));
+                        p->drawEllipse(childRect);
+                    }
+                } else {
+                    if (enable) {
+                        if (sunKen) {
+                            if (useDarkPalette) {
+                                p->setPen(QColor(36, 109, 212));
+                                p->setBrush(QColor(6, 35, 97));
+                            } else {
+                                p->setPen(QColor(36, 109, 212));
+                                p->setBrush(QColor(179, 221, 255));
+                            }
+                        } else if (mouseOver) {
+                            if (useDarkPalette) {
+                                p->setPen(QColor(55, 144, 250));
+                                p->setBrush(QColor(9, 53, 153));
+                            } else {
+                                p->setPen(QColor(97, 173, 255));
+                                p->setBrush(QColor(219, 240, 255));
+                            }
                         } else {
-                            painter->setPen(QColor(97, 173, 255));
-                            painter->setBrush(QColor(219, 240, 255));
+                            if (useDarkPalette) {
+                                p->setPen(QColor(72, 72, 77));
+                                p->setBrush(QColor(48, 48, 51));
+                            } else {
+                                p->setPen(QColor(191, 191, 191));
+                                p->setBrush(option->palette.brush(QPalette::Active, QPalette::Window));
+                            }
                         }
                     } else {
                         if (useDarkPalette) {
-                            painter->setPen(QColor(72, 72, 77));
-                            painter->setBrush(QColor(48, 48, 51));
+                            p->setPen(QColor(48, 48, 51));
+                            p->setBrush(QColor(28, 28, 30));
                         } else {
-                            painter->setPen(QColor(191, 191, 191));
-                            painter->setBrush(option->palette.brush(QPalette::Active, QPalette::Window));
+                            p->setPen(QColor(224, 224, 224));
+                            p->setBrush(QColor(233, 233, 233));
                         }
                     }
-                } else {
-                    if (useDarkPalette) {
-                        painter->setPen(QColor(48, 48, 51));
-                        painter->setBrush(QColor(28, 28, 30));
-                    } else {
-                        painter->setPen(QColor(224, 224, 224));
-                        painter->setBrush(QColor(233, 233, 233));
-                    }
+                    p->drawEllipse(rect);
                 }
-                painter->drawEllipse(rect);
-            }
-            painter->restore();
+            }, true);
             return;
         }
         break;
@@ -1673,88 +1845,90 @@ void Qt5UKUIStyle::drawPrimitive(QStyle::PrimitiveElement element, const QStyleO
             bool on = checkbox->state & State_On;
             bool noChange = checkbox->state & State_NoChange;
 
-            QRectF rect = checkbox->rect;
-            int width = rect.width();
-            int heigth = rect.height();
-            int x_Radius = 4;
-            int y_Radius = 4;
-
-            QPainterPath path;
-            if (on) {
-                path.moveTo(width/4 + checkbox->rect.left(), heigth/2 + checkbox->rect.top());
-                path.lineTo(width*0.45 + checkbox->rect.left(), heigth*3/4 + checkbox->rect.top());
-                path.lineTo(width*3/4 + checkbox->rect.left(), heigth/4 + checkbox->rect.top());
-            } else if (noChange){
-                path.moveTo(rect.left() + width/4, rect.center().y());
-                path.lineTo(rect.right() - width/4 , rect.center().y());
-            }
+            const QString key = QString("checkbox_%1_%2_%3_%4_%5_%6_%7").arg(enable).arg(mouseOver).arg(sunKen).arg(on)
+                    .arg(noChange).arg(useDarkPalette).arg(paletteKey(checkbox->palette));
+            drawCachedIndicator(painter, checkbox->rect, key, [&](QPainter *p, const QRect &indicatorRect) {
+                QRectF rect = indicatorRect;
+                int width = rect.width();
+                int heigth = rect.height();
+                int x_Radius = 4;
+                int y_Radius = 4;
 
-            painter->save();
-            painter->setClipRect(rect);
-            painter->setRenderHint(QPainter::Antialiasing,true);
-            if (enable) {
-                if (on | noChange) {
-                    if (sunKen) {
-                        painter->setPen(QColor(25, 101, 207));
-                        painter->setBrush(highLight_Click());
-                    } else if (mouseOver) {
-                        painter->setPen(QColor(36, 109, 212));
-                        painter->setBrush(highLight_Hover());
-                    } else {
-                        painter->setPen(QColor(36, 109, 212));
-                        painter->setBrush(checkbox->palette.brush(QPalette::Active, QPalette::Highlight));
-                    }
-                    painter->drawRoundedRect(rect, x_Radius, y_Radius);
+                QPainterPath path;
+                if (on) {
+                    path.moveTo(width/4 + indicatorRect.left(), heigth/2 + indicatorRect.top());
+                    path.lineTo(width*0.45 + indicatorRect.left(), heigth*3/4 + indicatorRect.top());
+                    path.lineTo(width*3/4 + indicatorRect.left(), heigth/4 + indicatorRect.top());
+                } else if (noChange){
+                    path.moveTo(rect.left() + width/4, rect.center().y());
+                    path.lineTo(rect.right() - width/4 , rect.center().y());
+                }
 
-                    painter->setPen(QPen(checkbox->palette.brush(QPalette::Active, QPalette::HighlightedText), 2,
-                                         Qt::SolidLine, Qt::RoundCap, Qt::RoundJoin));
-                    painter->setBrush(Qt::NoBrush);
-                    painter->drawPath(path);
-                } else {
-                    if (sunKen) {
-                        if (useDarkPalette) {
-                            painter->setPen(QColor(36, 109, 212));
-                            painter->setBrush(QColor(6, 35, 97));
-                        } else {
-                            painter->setPen(QColor(36, 109, 212));
-                            painter->setBrush(QColor(179, 221, 255));
-                        }
-                    } else if (mouseOver) {
-                        if (useDarkPalette) {
-                            painter->setPen(QColor(55, 144, 250));
-                            painter->setBrush(QColor(9, 53, 153));
+                p->setClipRect(rect);
+                p->setRenderHint(QPainter::Antialiasing,true);
+                if (enable) {
+                    if (on | noChange) {
+                        if (sunKen) {
+                            p->setPen(QColor(25, 101, 207));
+                            p->setBrush(highLight_Click());
+                        } else if (mouseOver) {
+                            p->setPen(QColor(36, 109, 212));
+                            p->setBrush(highLight_Hover());
                         } else {
-                            painter->setPen(QColor(97, 173, 255));
-                            painter->setBrush(QColor(219, 240, 255));
+                            p->setPen(QColor(36, 109, 212));
+                            p->setBrush(checkbox->palette.brush(QPalette::Active, QPalette::Highlight));
                         }
+                        p->drawRoundedRect(rect, x_Radius, y_Radius);
+
+                        p->setPen(QPen(checkbox->palette.brush(QPalette::Active, QPalette::HighlightedText), 2,
+                                       Qt::SolidLine, Qt::RoundCap, Qt::RoundJoin));
+                        p->setBrush(Qt::NoBrush);
+                        p->drawPath(path);
                     } else {
-                        if (useDarkPalette) {
-                            painter->setPen(QColor(72, 72, 77));
-                            painter->setBrush(QColor(48, 48, 51));
+                        if (sunKen) {
+                            if (useDarkPalette) {
+                                p->setPen(QColor(36, 109, 212));
+                                p->setBrush(QColor(6, 35, 97));
+                            } else {
+                                p->setPen(QColor(36, 109, 212));
+                                p->setBrush(QColor(179, 221, 255));
+                            }
+                        } else if (mouseOver) {
+                            if (useDarkPalette) {
+                                p->setPen(QColor(55, 144, 250));
+                                p->setBrush(QColor(9, 53, 153));
+                            } else {
+                                p->setPen(QColor(97, 173, 255));
+                                p->setBrush(QColor(219, 240, 255));
+                            }
                         } else {
-                            painter->setPen(QColor(191, 191, 191));
-                            painter->setBrush(checkbox->palette.color(QPalette::Active, QPalette::Window));
+                            if (useDarkPalette) {
+                                p->setPen(QColor(72, 72, 77));
+                                p->setBrush(QColor(48, 48, 51));
+                            } else {
+                                p->setPen(QColor(191, 191, 191));
+                                p->setBrush(checkbox->palette.color(QPalette::Active, QPalette::Window));
+                            }
                         }
+                        p->drawRoundedRect(rect, x_Radius, y_Radius);
                     }
-                    painter->drawRoundedRect(rect, x_Radius, y_Radius);
-                }
-            } else {
-                if (useDarkPalette) {
-                    painter->setPen(QColor(48, 48, 51));
-                    painter->setBrush(QColor(28, 28, 30));
                 } else {
-                    painter->setPen(QColor(224, 224, 224));
-                    painter->setBrush(QColor(233, 233, 233));
-                }
-                painter->drawRoundedRect(rect, x_Radius, y_Radius);
-                if (on | noChange) {
-                    painter->setPen(QPen(checkbox->palette.brush(QPalette::Disabled, QPalette::ButtonText), 2,
-                                         Qt::SolidLine, Qt::RoundCap, Qt::RoundJoin));
-                    painter->setBrush(Qt::NoBrush);
-                    painter->drawPath(path);
+                    if (useDarkPalette) {
+                        p->setPen(QColor(48, 48, 51));
+                        p->setBrush(QColor(28, 28, 30));
+                    } else {
+                        p->setPen(QColor(224, 224, 224));
+                        p->setBrush(QColor(233, 233, 233));
+                    }
+                    p->drawRoundedRect(rect, x_Radius, y_Radius);
+                    if (on | noChange) {
+                        p->setPen(QPen(checkbox->palette.brush(QPalette::Disabled, QPalette::ButtonText), 2,
+                                       Qt::SolidLine, Qt::RoundCap, Qt::RoundJoin));
+                        p->setBrush(Qt::NoBrush);
+                        p->drawPath(path);
+                    }
                 }
-            }
-            painter->restore();
+            }, true);
             return;
         }
         break;
@@ -1796,6 +1970,8 @@ void Qt5UKUIStyle::drawPrimitive(QStyle::PrimitiveElement element, const QStyleO
 
 void Qt5UKUIStyle::drawComplexControl(QStyle::ComplexControl control, const QStyleOptionComplex *option, QPainter *painter, const QWidget *widget) const
 {
+    PaintStatistics::ElementTimer elementTimer(PaintStatistics::ComplexControl, control);
+
     switch (control) {
     case CC_ScrollBar: {
         if (const QStyleOptionSlider *bar = qstyleoption_cast<const QStyleOptionSlider *>(option)) {
@@ -1831,7 +2007,7 @@ void Qt5UKUIStyle::drawComplexControl(QStyle::ComplexControl control, const QSty
                 painter->setPen(Qt::NoPen);
                 painter->setBrush(comboBox->palette.brush(QPalette::Disabled, QPalette::Button));
                 painter->setRenderHint(QPainter::Antialiasing,true);
-                painter->drawRoundedRect(option->rect, 4, 4);
+                drawNineSliceRoundedRect(painter, option->rect, 4, 4);
                 painter->restore();
                 return;
             }
@@ -1847,7 +2023,7 @@ void Qt5UKUIStyle::drawComplexControl(QStyle::ComplexControl control, const QSty
                     painter->setBrush(option->palette.brush(QPalette::Active, QPalette::Button));
                 }
                 painter->setRenderHint(QPainter::Antialiasing, true);
-                painter->drawRoundedRect(option->rect.adjusted(1, 1, -1, -1), 4, 4);
+                drawNineSliceRoundedRect(painter, option->rect.adjusted(1, 1, -1, -1), 4, 4);
                 painter->restore();
             } else {
                 QStyleOptionButton button;
@@ -1860,7 +2036,7 @@ void Qt5UKUIStyle::drawComplexControl(QStyle::ComplexControl control, const QSty
                                          2, Qt::SolidLine, Qt::RoundCap, Qt::RoundJoin));
                     painter->setBrush(Qt::NoBrush);
                     painter->setRenderHint(QPainter::Antialiasing,true);
-                    painter->drawRoundedRect(option->rect.adjusted(1, 1, -1, -1), 4, 4);
+                    drawNineSliceRoundedRect(painter, option->rect.adjusted(1, 1, -1, -1), 4, 4);
                     painter->restore();
                 }
             }
@@ -1872,7 +2048,7 @@ void Qt5UKUIStyle::drawComplexControl(QStyle::ComplexControl control, const QSty
                                      1, Qt::SolidLine, Qt::RoundCap, Qt::RoundJoin));
                 painter->setBrush(Qt::NoBrush);
                 painter->setRenderHint(QPainter::Antialiasing,true);
-                painter->drawRoundedRect(rect.adjusted(1, 1, -1, -1), 4, 4);
+                drawNineSliceRoundedRect(painter, rect.adjusted(1, 1, -1, -1), 4, 4);
                 painter->restore();
             }
 
@@ -1902,7 +2078,7 @@ void Qt5UKUIStyle::drawComplexControl(QStyle::ComplexControl control, const QSty
                 painter->setPen(Qt::NoPen);
                 painter->setBrush(sb->palette.brush(QPalette::Disabled, QPalette::Button));
                 painter->setRenderHint(QPainter::Antialiasing, true);
-                painter->drawRoundedRect(option->rect, 4, 4);
+                drawNineSliceRoundedRect(painter, option->rect, 4, 4);
                 painter->restore();
             } else if (sb->stepEnabled == QAbstractSpinBox::StepNone) {
                 upOption.state = State_Enabled;
@@ -1911,7 +2087,7 @@ void Qt5UKUIStyle::drawComplexControl(QStyle::ComplexControl control, const QSty
                 painter->setRenderHint(QPainter::Antialiasing, true);
                 painter->setPen(Qt::NoPen);
                 painter->setBrush(sb->palette.brush(QPalette::Active, QPalette::Button));
-                painter->drawRoundedRect(option->rect, 4, 4);
+                drawNineSliceRoundedRect(painter, option->rect, 4, 4);
                 painter->restore();
             } else {
                 upOption.state |= State_Enabled;
@@ -1922,7 +2098,7 @@ void Qt5UKUIStyle::drawComplexControl(QStyle::ComplexControl control, const QSty
                                          2, Qt::SolidLine, Qt::RoundCap, Qt::RoundJoin));
                     painter->setBrush(option->palette.brush(QPalette::Active, QPalette::Base));
                     painter->setRenderHint(QPainter::Antialiasing, true);
-                    painter->drawRoundedRect(option->rect.adjusted(1, 1, -1, -1), 4, 4);
+                    drawNineSliceRoundedRect(painter, option->rect.adjusted(1, 1, -1, -1), 4, 4);
                     painter->restore();
                 } else {
                     QStyleOptionButton button;
@@ -1937,7 +2113,7 @@ void Qt5UKUIStyle::drawComplexControl(QStyle::ComplexControl control, const QSty
                                              1, Qt::SolidLine, Qt::RoundCap, Qt::RoundJoin));
                         painter->setBrush(Qt::NoBrush);
                         painter->setRenderHint(QPainter::Antialiasing, true);
-                        painter->drawRoundedRect(rect.adjusted(0.5, 0.5, -0.5, -0.5), 4, 4);
+                        drawNineSliceRoundedRect(painter, rect.adjusted(0.5, 0.5, -0.5, -0.5), 4, 4);
                         painter->restore();
                     }
                 }
@@ -2379,6 +2555,19 @@ void Qt5UKUIStyle::drawComplexControl(QStyle::ComplexControl control, const QSty
 
 void Qt5UKUIStyle::drawControl(QStyle::ControlElement element, const QStyleOption *option, QPainter *painter, const QWidget *widget) const
 {
+    AnimationQualityGovernor::PaintTimer paintTimer;
+    PaintStatistics::ElementTimer elementTimer(PaintStatistics::Control, element);
+
+    if (m_paint_recording) {
+        PaintRecorder::Key key;
+        if (PaintRecorder::makeKey(element, option, painter, widget, &key)) {
+            PaintRecorder::globalInstance()->draw(painter, key, option->rect, [&](QPainter *p) {
+                drawControl(element, option, p, widget);
+            });
+            return;
+        }
+    }
+
     switch (element) {
     case CE_ItemViewItem: {
         auto p = painter;
@@ -2971,26 +3160,45 @@ void Qt5UKUIStyle::drawControl(QStyle::ControlElement element, const QStyleOptio
                     }
                 }
 
-                int TabBarTab_Radius = 6;
-                QPainterPath path;
-                path.moveTo(drawRect.left() + TabBarTab_Radius, drawRect.top());
-                path.arcTo(QRect(drawRect.left(), drawRect.top(), TabBarTab_Radius * 2, TabBarTab_Radius * 2), 90, 90);
-                path.lineTo(drawRect.left(), drawRect.bottom() - TabBarTab_Radius);
-                path.arcTo(QRect(drawRect.left() - TabBarTab_Radius * 2, drawRect.bottom() - TabBarTab_Radius * 2,
-                                 TabBarTab_Radius * 2, TabBarTab_Radius * 2), 0, -90);
-                path.lineTo(drawRect.right() + TabBarTab_Radius, drawRect.bottom());
-                path.arcTo(QRect(drawRect.right(), drawRect.bottom() - TabBarTab_Radius * 2,
-                                 TabBarTab_Radius * 2, TabBarTab_Radius * 2), 270, -90);
-                path.lineTo(drawRect.right(), drawRect.top() + TabBarTab_Radius);
-                path.arcTo(QRect(drawRect.right() - TabBarTab_Radius * 2, drawRect.top(),
-                                 TabBarTab_Radius * 2, TabBarTab_Radius * 2), 0, 90);
-                path.lineTo(drawRect.left() + TabBarTab_Radius, drawRect.top());
-
-                painter->setBrush(tab->palette.brush(QPalette::Active, QPalette::Base));
+                const int TabBarTab_Radius = 6;
+                auto tabPath = [](const QRect &drawRect, int TabBarTab_Radius) {
+                    QPainterPath path;
+                    path.moveTo(drawRect.left() + TabBarTab_Radius, drawRect.top());
+                    path.arcTo(QRect(drawRect.left(), drawRect.top(), TabBarTab_Radius * 2, TabBarTab_Radius * 2), 90, 90);
+                    path.lineTo(drawRect.left(), drawRect.bottom() - TabBarTab_Radius);
+                    path.arcTo(QRect(drawRect.left() - TabBarTab_Radius * 2, drawRect.bottom() - TabBarTab_Radius * 2,
+                                     TabBarTab_Radius * 2, TabBarTab_Radius * 2), 0, -90);
+                    path.lineTo(drawRect.right() + TabBarTab_Radius, drawRect.bottom());
+                    path.arcTo(QRect(drawRect.right(), drawRect.bottom() - TabBarTab_Radius * 2,
+                                     TabBarTab_Radius * 2, TabBarTab_Radius * 2), 270, -90);
+                    path.lineTo(drawRect.right(), drawRect.top() + TabBarTab_Radius);
+                    path.arcTo(QRect(drawRect.right() - TabBarTab_Radius * 2, drawRect.top(),
+                                     TabBarTab_Radius * 2, TabBarTab_Radius * 2), 0, 90);
+                    path.lineTo(drawRect.left() + TabBarTab_Radius, drawRect.top());
+                    return path;
+                };
+
+                QBrush brush = tab->palette.brush(QPalette::Active, QPalette::Base);
                 if (hover && !selected)
-                    painter->setBrush(mixColor(tab->palette.color(QPalette::Active, QPalette::Base),
-                                               tab->palette.color(QPalette::Active, QPalette::Window), 0.6));
-                painter->drawPath(path);
+                    brush = mixColor(tab->palette.color(QPalette::Active, QPalette::Base),
+                                     tab->palette.color(QPalette::Active, QPalette::Window), 0.6);
+
+                if (brush.style() == Qt::SolidPattern) {
+                    // the bottom corners flare out by the radius, keep them and the antialiased edge in the footprint.
+                    const int margin = TabBarTab_Radius + 1;
+                    const QColor color = brush.color();
+                    drawNineSlice(painter, drawRect.adjusted(-margin, -1, margin, 1), TabBarTab_Radius * 2 + 2,
+                                  QString("tab_%1_%2").arg(color.rgba()).arg(TabBarTab_Radius),
+                                  [=](QPainter *p, const QRect &footprint) {
+                        p->setPen(Qt::NoPen);
+                        p->setBrush(color);
+                        p->setRenderHint(QPainter::Antialiasing, true);
+                        p->drawPath(tabPath(footprint.adjusted(margin, 1, -margin, -1), TabBarTab_Radius));
+                    });
+                } else {
+                    painter->setBrush(brush);
+                    painter->drawPath(tabPath(drawRect, TabBarTab_Radius));
+                }
             } else {
                 painter->setBrush(tab->palette.brush(QPalette::Active, QPalette::Window));
                 painter->drawRect(drawRect);
@@ -3557,19 +3765,8 @@ void Qt5UKUIStyle::drawControl(QStyle::ControlElement element, const QStyleOptio
             int diff = 0;
             if (indeterminate) {
                 len = 56;
-                double currentValue = 0;
-                if (QVariantAnimation *animation = m_animation_helper->animation(option->styleObject)) {
-                    currentValue = animation->currentValue().toDouble();
-                    if (animation->currentTime() == 0) {
-                        animation->setDirection(QAbstractAnimation::Forward);
-                        animation->start();
-                    } else if (animation->currentTime() == animation->totalDuration()) {
-                        animation->setDirection(QAbstractAnimation::Backward);
-                        animation->start();
-                    }
-                } else {
-                    m_animation_helper->startAnimation(new ProgressBarAnimation(option->styleObject));
-                }
+                m_animation_helper->startAnimation(option->styleObject);
+                double currentValue = m_animation_helper->currentValue();
                 diff = currentValue * (maxWidth - len);
             } else {
                 m_animation_helper->stopAnimation(option->styleObject);
@@ -3907,6 +4104,21 @@ int Qt5UKUIStyle::pixelMetric(QStyle::PixelMetric metric, const QStyleOption *op
 }
 
 QRect Qt5UKUIStyle::subControlRect(QStyle::ComplexControl control, const QStyleOptionComplex *option, QStyle::SubControl subControl, const QWidget *widget) const
+{
+    SubRectMemo::Key key;
+    if (!SubRectMemo::makeKey(control, option, subControl, widget, &key))
+        return realSubControlRect(control, option, subControl, widget);
+
+    QRect rect;
+    if (SubRectMemo::globalInstance()->find(key, &rect))
+        return rect;
+
+    rect = realSubControlRect(control, option, subControl, widget);
+    SubRectMemo::globalInstance()->insert(key, rect);
+    return rect;
+}
+
+QRect Qt5UKUIStyle::realSubControlRect(QStyle::ComplexControl control, const QStyleOptionComplex *option, QStyle::SubControl subControl, const QWidget *widget) const
 {
     switch (control) {
     case CC_ScrollBar: {
@@ -4158,6 +4370,21 @@ QRect Qt5UKUIStyle::subControlRect(QStyle::ComplexControl control, const QStyleO
 }
 
 QRect Qt5UKUIStyle::subElementRect(SubElement element, const QStyleOption *option, const QWidget *widget) const
+{
+    SubRectMemo::Key key;
+    if (!SubRectMemo::makeKey(element, option, widget, &key))
+        return realSubElementRect(element, option, widget);
+
+    QRect rect;
+    if (SubRectMemo::globalInstance()->find(key, &rect))
+        return rect;
+
+    rect = realSubElementRect(element, option, widget);
+    SubRectMemo::globalInstance()->insert(key, rect);
+    return rect;
+}
+
+QRect Qt5UKUIStyle::realSubElementRect(SubElement element, const QStyleOption *option, const QWidget *widget) const
 {
     switch (element) {
     case SE_TabBarScrollLeftButton:
@@ -4925,11 +5152,11 @@ void Qt5UKUIStyle::realSetWindowSurfaceFormatAlpha(const QWidget *widget) const
     if (widget->testAttribute(Qt::WA_WState_Created))
         return;
 
-    if (auto menu = qobject_cast<const QMenu *>(widget)) {
-        const_cast<QWidget *>(widget)->setAttribute(Qt::WA_TranslucentBackground);
-    }
+    // translucent surfaces are never visible without a compositor.
+    if (useOpaqueSurfaces())
+        return;
 
-    if (shouldBeTransparent(widget))
+    if (qobject_cast<const QMenu *>(widget) || shouldBeTransparent(widget))
         const_cast<QWidget *>(widget)->setAttribute(Qt::WA_TranslucentBackground);
 }
 
@@ -115,10 +115,51 @@ protected:
     const QStringList useDefaultPalette() const;
     void viewItemDrawText(QPainter *p, const QStyleOptionViewItem *option, const QRect &rect) const;
 
+    /*!
+     * \brief realSetWindowSurfaceFormatAlpha
+     * \details
+     * the surface format is chosen when the native window is created, so menus
+     * and tooltips are made translucent when they are polished, which is before
+     * that. The popup container of combo box is handled in eventFilter().
+     * realSetMenuTypeToMenu() is called on QEvent::WinIdChange, when the
+     * native window is created.
+     */
     void realSetWindowSurfaceFormatAlpha(const QWidget *widget) const;
+    /*!
+     * \brief useOpaqueSurfaces
+     * \return true in low end mode or when there is no compositor. Menus and
+     * tooltips are created as rgb windows and painted with square opaque
+     * frames without shadow.
+     */
+    bool useOpaqueSurfaces() const;
+    bool shouldPaintOpaqueFrame(const QWidget *widget) const;
+    void updateSurfaceMode();
+    /*!
+     * \brief isTabletModeSensitive
+     * \return true if the style hints or metrics of the widget depend on the
+     * tablet mode. For now that is SH_ItemView_ActivateItemOnSingleClick of
+     * item views, a tablet specific metric has to add its widgets here.
+     * Applications caching a tablet dependent hint of their own widgets set
+     * the "tabletModeAware" property on them.
+     */
+    bool isTabletModeSensitive(const QWidget *widget) const;
     void realSetMenuTypeToMenu(const QWidget *widget) const;
     QRect centerRect(const QRect &rect, int width, int height) const;
 
+    /*!
+     * \brief realSubControlRect
+     * \details
+     * subControlRect() and subElementRect() look up SubRectMemo first, and
+     * compute the rects with these.
+     */
+    QRect realSubControlRect(QStyle::ComplexControl control,
+                             const QStyleOptionComplex *option,
+                             QStyle::SubControl subControl,
+                             const QWidget *widget) const;
+    QRect realSubElementRect(SubElement element,
+                             const QStyleOption *option,
+                             const QWidget *widget) const;
+
 private:
     TabWidgetAnimationHelper *m_tab_animation_helper;
     ScrollBarAnimationHelper *m_scrollbar_animation_helper;
@@ -138,12 +179,31 @@ private:
     bool m_is_tablet_mode = false;
     QDBusInterface *m_statusManagerDBus = nullptr;
 
+    /*!
+     * \brief m_low_end_mode
+     * org.ukui.style "low-end-mode". No custom shadows, no translucent
+     * menus and tooltips, and no blurred frames are painted.
+     * Animations are turned off by AnimationQualityGovernor.
+     */
+    bool m_low_end_mode = false;
+    bool m_compositing = true;
+
+    /*!
+     * \brief m_paint_recording
+     * org.ukui.style "paint-recording". Record some controls into pictures
+     * and replay them for identical options, see PaintRecorder.
+     */
+    bool m_paint_recording = false;
+
     QColor button_Click() const;
     QColor button_Hover() const;
     QColor button_DisableChecked() const;
 
 private Q_SLOTS:
+    void watchSettings();
     void updateTabletModeValue(bool isTabletMode);
+    void updateLowEndMode(bool lowEndMode);
+    void updateCompositing(bool active);
 };
 
 #endif // QT5UKUISTYLE_H
@@ -41,24 +41,23 @@ bool ScrollBarAnimationHelper::registerWidget(QWidget *w)
     }
     else
     {
-        m_animators->insert(w, animator);
+        setSlotAnimator(w, ScrollBarSlot, animator);
     }
     return result;
 }
 
 bool ScrollBarAnimationHelper::unregisterWidget(QWidget *w)
 {
-    auto animator = w->findChild<UKUI::ScrollBar::DefaultInteractionAnimator*>("ukui_scrollbar_default_interaction_animator", Qt::FindDirectChildrenOnly);
+    auto animator = takeSlotAnimator(w, ScrollBarSlot);
     bool result = false;
     if (animator) {
         result = animator->unboundWidget();
-        animator->deleteLater();
+        delete animator;
     }
-    m_animators->remove(w);
     return result;
 }
 
 AnimatorIface *ScrollBarAnimationHelper::animator(const QWidget *w)
 {
-    return m_animators->value(w);
+    return slotAnimator(w, ScrollBarSlot);
 }
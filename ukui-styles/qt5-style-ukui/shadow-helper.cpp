@@ -21,6 +21,8 @@
  */
 
 #include "shadow-helper.h"
+#include "paint-statistics.h"
+#include "disk-image-cache.h"
 
 #include <QPainter>
 #include <QPainterPath>
@@ -71,6 +73,8 @@ bool ShadowHelper::isWidgetNeedDecoShadow(const QWidget *widget)
 void ShadowHelper::registerWidget(QWidget *widget)
 {
     widget->removeEventFilter(this);
+    if (!m_enabled)
+        return;
 
     bool needCreateShadowInstantly = false;
     if (isWidgetNeedDecoShadow(widget)) {
@@ -136,8 +140,37 @@ void ShadowHelper::unregisterWidget(const QWidget *widget)
     }
 }
 
+void ShadowHelper::setShadowEnabled(bool enabled)
+{
+    if (m_enabled == enabled)
+        return;
+
+    m_enabled = enabled;
+    if (!enabled) {
+        for (auto shadow : m_shadows) {
+            if (shadow->isCreated())
+                shadow->destroy();
+            shadow->deleteLater();
+        }
+        m_shadows.clear();
+        return;
+    }
+
+    for (auto widget : qApp->topLevelWidgets()) {
+        registerWidget(widget);
+    }
+}
+
 QPixmap ShadowHelper::getShadowPixmap(QColor color, /*ShadowHelper::State state,*/ int shadow_border, qreal darkness, int borderRadiusTopLeft, int borderRadiusTopRight, int borderRadiusBottomLeft, int borderRadiusBottomRight)
 {
+    const QString key = QString("shadow_%1_%2_%3_%4_%5_%6_%7").arg(color.rgba()).arg(shadow_border).arg(darkness)
+            .arg(borderRadiusTopLeft).arg(borderRadiusTopRight).arg(borderRadiusBottomLeft).arg(borderRadiusBottomRight);
+    QImage cachedShadow;
+    if (DiskImageCache::globalInstance()->find(key, &cachedShadow))
+        return QPixmap::fromImage(cachedShadow);
+
+    PaintStatistics::count(PaintStatistics::ShadowGenerations);
+
     int maxTopRadius = qMax(borderRadiusTopLeft, borderRadiusTopRight);
     int maxBottomRadius = qMax(borderRadiusBottomLeft, borderRadiusBottomRight);
     int maxRadius = qMax(maxTopRadius, maxBottomRadius);
@@ -219,7 +252,9 @@ QPixmap ShadowHelper::getShadowPixmap(QColor color, /*ShadowHelper::State state,
     painter2.translate(shadow_border, shadow_border);
     painter2.translate(-0.5, -0.5);
     painter2.drawPath(borderPath);
+    painter2.end();
 
+    DiskImageCache::globalInstance()->insert(key, darkerTarget.toImage());
     return darkerTarget;
 }
 
@@ -311,6 +346,9 @@ KWindowShadow *ShadowHelper::getShadow(QColor color, int shadow_border, qreal da
 
 bool ShadowHelper::eventFilter(QObject *watched, QEvent *event)
 {
+    if (!m_enabled)
+        return false;
+
     if (watched->isWidgetType()) {
         auto widget = qobject_cast<QWidget *>(watched);
         if (QX11Info::isPlatformX11() && event->type() == QEvent::Show) {
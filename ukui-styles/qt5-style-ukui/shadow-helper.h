@@ -42,6 +42,14 @@ public:
     void registerWidget(QWidget *widget);
     void unregisterWidget(const QWidget *widget);
 
+    /*!
+     * \brief setShadowEnabled
+     * \details
+     * disabling destroys all created shadows, enabling creates them again for
+     * the visible top level widgets. Hidden ones get their shadows when shown.
+     */
+    void setShadowEnabled(bool enabled);
+
     QPixmap getShadowPixmap(/*State state,*/
                             QColor color,
                             int shadow_border,
@@ -68,6 +76,7 @@ public:
 
 private:
     QMap<const QWidget *, KWindowShadow *> m_shadows;
+    bool m_enabled = true;
 };
 
 #endif // SHADOWHELPER_H
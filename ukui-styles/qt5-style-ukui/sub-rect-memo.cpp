@@ -0,0 +1,178 @@
+/*
+ * Qt5-UKUI's Library
+ *
+ * Copyright (C) 2020, Tianjin KYLIN Information Technology Co., Ltd.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this library.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * Authors: Yue Lan <lanyue@kylinos.cn>
+ *
+ */
+
+#include "sub-rect-memo.h"
+#include "paint-statistics.h"
+
+#include <QStyleOption>
+#include <QWidget>
+#include <QTimer>
+#include <QDebug>
+
+#define KIND_COMPLEX_CONTROL 0
+#define KIND_SUB_ELEMENT 1
+
+static SubRectMemo *global_instance = nullptr;
+
+SubRectMemo *SubRectMemo::globalInstance()
+{
+    if (!global_instance)
+        global_instance = new SubRectMemo;
+    return global_instance;
+}
+
+static void addCommonFields(const QStyleOption *option, SubRectMemo::Key *key)
+{
+    key->fields << option->rect.x() << option->rect.y() << option->rect.width() << option->rect.height()
+                << int(option->state) << int(option->direction);
+}
+
+bool SubRectMemo::makeKey(QStyle::ComplexControl control, const QStyleOption *option,
+                          QStyle::SubControl subControl, const QWidget *widget, Key *key)
+{
+    if (!option)
+        return false;
+
+    key->fields << KIND_COMPLEX_CONTROL << int(control) << int(subControl);
+    key->widget = widget;
+    addCommonFields(option, key);
+
+    switch (control) {
+    case QStyle::CC_ScrollBar:
+    case QStyle::CC_Slider: {
+        auto slider = qstyleoption_cast<const QStyleOptionSlider *>(option);
+        if (!slider)
+            return false;
+        key->fields << int(slider->subControls) << int(slider->orientation)
+                    << slider->minimum << slider->maximum << slider->sliderPosition << slider->sliderValue
+                    << slider->singleStep << slider->pageStep << int(slider->upsideDown)
+                    << int(slider->tickPosition) << slider->tickInterval;
+        return true;
+    }
+    case QStyle::CC_SpinBox: {
+        auto spinBox = qstyleoption_cast<const QStyleOptionSpinBox *>(option);
+        if (!spinBox)
+            return false;
+        key->fields << int(spinBox->subControls) << int(spinBox->buttonSymbols)
+                    << int(spinBox->stepEnabled) << int(spinBox->frame);
+        return true;
+    }
+    case QStyle::CC_ComboBox: {
+        auto comboBox = qstyleoption_cast<const QStyleOptionComboBox *>(option);
+        if (!comboBox)
+            return false;
+        key->fields << int(comboBox->subControls) << int(comboBox->editable) << int(comboBox->frame)
+                    << comboBox->iconSize.width() << comboBox->iconSize.height();
+        return true;
+    }
+    default:
+        return false;
+    }
+}
+
+bool SubRectMemo::makeKey(QStyle::SubElement element, const QStyleOption *option,
+                          const QWidget *widget, Key *key)
+{
+    if (!option)
+        return false;
+
+    switch (element) {
+    case QStyle::SE_ItemViewItemCheckIndicator:
+    case QStyle::SE_ItemViewItemDecoration:
+    case QStyle::SE_ItemViewItemText:
+    case QStyle::SE_ItemViewItemFocusRect: {
+        auto item = qstyleoption_cast<const QStyleOptionViewItem *>(option);
+        if (!item)
+            return false;
+        key->fields << KIND_SUB_ELEMENT << int(element);
+        key->widget = widget;
+        addCommonFields(option, key);
+        key->fields << int(item->features) << int(item->decorationPosition)
+                    << int(item->decorationAlignment) << int(item->displayAlignment)
+                    << item->decorationSize.width() << item->decorationSize.height()
+                    << int(item->textElideMode) << int(item->checkState) << int(item->icon.isNull())
+                    << int(item->viewItemPosition);
+        // the text rect is sized from the laid out text.
+        key->text = item->text;
+        key->font = item->font;
+        return true;
+    }
+    default:
+        return false;
+    }
+}
+
+bool SubRectMemo::find(const Key &key, QRect *rect)
+{
+    auto it = m_rects.constFind(key);
+    PaintStatistics::countCache(PaintStatistics::SubRectMemoHits, it != m_rects.constEnd());
+    if (it == m_rects.constEnd())
+        return false;
+
+    *rect = it.value();
+#ifdef QT_DEBUG
+    m_reused++;
+#endif
+    return true;
+}
+
+void SubRectMemo::insert(const Key &key, const QRect &rect)
+{
+    m_rects.insert(key, rect);
+#ifdef QT_DEBUG
+    m_computed++;
+#endif
+
+    if (!m_clear_scheduled) {
+        m_clear_scheduled = true;
+        QTimer::singleShot(0, [=]() {
+            clear();
+        });
+    }
+}
+
+void SubRectMemo::clear()
+{
+#ifdef QT_DEBUG
+    static const bool printStatistics = qEnvironmentVariableIsSet("QT5UKUI_DEBUG_SUB_RECT_MEMO");
+    if (printStatistics)
+        qInfo() << "sub rect memo:" << m_computed << "rects computed," << m_reused << "reused";
+    m_computed = 0;
+    m_reused = 0;
+#endif
+    m_rects.clear();
+    m_clear_scheduled = false;
+}
+
+bool operator==(const SubRectMemo::Key &a, const SubRectMemo::Key &b)
+{
+    return a.widget == b.widget && a.fields == b.fields && a.text == b.text && a.font == b.font;
+}
+
+uint qHash(const SubRectMemo::Key &key, uint seed)
+{
+    uint hash = qHashRange(key.fields.constBegin(), key.fields.constEnd(), seed);
+    hash ^= qHash(key.widget, seed);
+    if (!key.text.isEmpty())
+        hash ^= qHash(key.text, seed);
+    return hash;
+}
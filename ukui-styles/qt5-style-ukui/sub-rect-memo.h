@@ -0,0 +1,91 @@
+/*
+ * Qt5-UKUI's Library
+ *
+ * Copyright (C) 2020, Tianjin KYLIN Information Technology Co., Ltd.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this library.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * Authors: Yue Lan <lanyue@kylinos.cn>
+ *
+ */
+
+#ifndef SUBRECTMEMO_H
+#define SUBRECTMEMO_H
+
+#include <QHash>
+#include <QRect>
+#include <QFont>
+#include <QVarLengthArray>
+#include <QStyle>
+
+class QStyleOption;
+class QWidget;
+
+/*!
+ * \brief The SubRectMemo class
+ * \details
+ * Painting and hit testing one scroll bar, slider, spin box or combo box asks
+ * for the same sub control rects several times, and an item view cell asks
+ * for its check, decoration and text rects once from its paint and again from
+ * each sub element query, each time through the whole proxy chain.
+ *
+ * SubRectMemo remembers the rects computed during one event loop iteration,
+ * keyed by the control, the widget and every option field the geometry
+ * depends on. It is cleared when control returns to the event loop, so
+ * geometry changes between frames are never served from the memo.
+ *
+ * In debug builds, set QT5UKUI_DEBUG_SUB_RECT_MEMO to print how many rects
+ * were computed and reused in each frame.
+ */
+class SubRectMemo
+{
+public:
+    struct Key {
+        QVarLengthArray<int, 24> fields;
+        const QWidget *widget = nullptr;
+        QString text;
+        QFont font;
+    };
+
+    static SubRectMemo *globalInstance();
+
+    /*!
+     * \brief makeKey
+     * \return false if the geometry of this control is not memoized.
+     */
+    static bool makeKey(QStyle::ComplexControl control, const QStyleOption *option,
+                        QStyle::SubControl subControl, const QWidget *widget, Key *key);
+    static bool makeKey(QStyle::SubElement element, const QStyleOption *option,
+                        const QWidget *widget, Key *key);
+
+    bool find(const Key &key, QRect *rect);
+    void insert(const Key &key, const QRect &rect);
+
+private:
+    SubRectMemo() {}
+    void clear();
+
+    QHash<Key, QRect> m_rects;
+    bool m_clear_scheduled = false;
+
+#ifdef QT_DEBUG
+    int m_computed = 0;
+    int m_reused = 0;
+#endif
+};
+
+bool operator==(const SubRectMemo::Key &a, const SubRectMemo::Key &b);
+uint qHash(const SubRectMemo::Key &key, uint seed = 0);
+
+#endif // SUBRECTMEMO_H
@@ -31,24 +31,25 @@ TabWidgetAnimationHelper::TabWidgetAnimationHelper(QObject *parent) : AnimationH
 bool TabWidgetAnimationHelper::registerWidget(QWidget *w)
 {
     auto animator = new UKUI::TabWidget::DefaultSlideAnimator;
-    if (!animator->bindWidget(w))
+    if (!animator->bindWidget(w)) {
+        delete animator;
         return false;
-    m_animators->insert(w, animator);
+    }
+    setSlotAnimator(w, TabWidgetSlot, animator);
     return true;
 }
 
 bool TabWidgetAnimationHelper::unregisterWidget(QWidget *w)
 {
-    auto animator = m_animators->value(w);
+    auto animator = takeSlotAnimator(w, TabWidgetSlot);
     if (animator) {
         animator->unboundWidget();
         delete animator;
     }
-    m_animators->remove(w);
     return true;
 }
 
 AnimatorIface *TabWidgetAnimationHelper::animator(const QWidget *w)
 {
-    return m_animators->value(w);
+    return slotAnimator(w, TabWidgetSlot);
 }